@@ -0,0 +1,749 @@
+/*
+ * PolyBench Tuning Benchmark: PLUTO-guided search vs Tiramisu beam search
+ *
+ * For every kernel of external/pluto/examples:
+ * 1. Bridge: pet extracts the SCoP from the C source, PLUTO transforms it and
+ *    HybridOptimizer searches / measures candidates on the Tiramisu program
+ * 2. Tiramisu: beam_search + evaluate_by_execution on the same program
+ *
+ * Both sides report search wall time, number of measured schedules and the
+ * speedup of their final schedule over the unscheduled program, each measured
+ * with its own execution harness. Results are written as JSON.
+ *
+ * Each side of every kernel runs in its own forked child on a freshly built
+ * program: Tiramisu keeps one implicit function per process, and both
+ * searches reset its schedules, which drops the declared then/after order.
+ * The binary is also the beam-search timing wrapper:
+ *   benchmark_polybench_tuning --wrapper <so> <function> <runs> <shape>...
+ * and checks decompose_statement_schedule on fixed matrices (exit code 1 on
+ * a mismatch):
+ *   benchmark_polybench_tuning --check-decomposition
+ *
+ * Usage:
+ *   benchmark_polybench_tuning [--kernels gemm,lu,...] [--output file.json]
+ *                              [--strategy optimal_neighbors] [--runs 10]
+ *                              (--strategy stencil: PLUTO diamond tiling)
+ *                              [--beam-size 2] [--max-depth 4]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "pluto_guided_search.h"
+#include "bridge_profiler.h"
+#include <tiramisu/auto_scheduler/evaluator.h>
+#include <tiramisu/auto_scheduler/search_method.h>
+
+#include <gmp.h>
+extern "C" {
+#include "pluto/pluto.h"
+#include "math_support.h"
+#include "program.h"
+}
+#include "pet_to_pluto.h"
+
+#ifndef PLUTO_EXAMPLES_DIR
+#define PLUTO_EXAMPLES_DIR "external/pluto/examples"
+#endif
+
+using namespace pluto_tiramisu;
+using namespace tiramisu;
+
+// ============================================================================
+// Kernels (Tiramisu programs mirroring the PLUTO example sources)
+// ============================================================================
+//
+// Statements are declared in source order so that PLUTO statement k maps to
+// statements[k]. Loop variables carry the C iterator names, which is what
+// the bridge's schedules refer to. Sizes are reduced so that both searches
+// finish in minutes; PLUTO's schedule does not depend on them.
+
+struct KernelProgram {
+    std::vector<computation*> statements;
+    std::vector<buffer*> arguments;
+    std::vector<std::vector<int>> shapes;   // Per argument, outer -> inner
+    
+    buffer* add_buffer(const std::string& name, const std::vector<int>& shape,
+                       argument_t kind) {
+        std::vector<expr> sizes;
+        for (int s : shape) sizes.push_back(expr(s));
+        buffer* b = new buffer(name, sizes, p_float64, kind);
+        arguments.push_back(b);
+        shapes.push_back(shape);
+        return b;
+    }
+};
+
+struct Kernel {
+    std::string name;
+    std::string source;     // Relative to PLUTO_EXAMPLES_DIR
+    std::function<void(KernelProgram&)> build;
+};
+
+// C[i][j] = beta*C[i][j] + alpha*A[i][k]*B[k][j]  (alpha = beta = 1)
+static void build_gemm(KernelProgram& p) {
+    const int M = 512, N = 512, K = 512;
+    var i("i", 0, M), j("j", 0, N), k("k", 0, K);
+    
+    input* A = new input("A_in", {i, k}, p_float64);
+    input* B = new input("B_in", {k, j}, p_float64);
+    input* C = new input("C_in", {i, j}, p_float64);
+    computation* S = new computation("S", {i, j, k}, (*C)(i, j) + (*A)(i, k) * (*B)(k, j));
+    
+    buffer* bA = p.add_buffer("A", {M, K}, a_input);
+    buffer* bB = p.add_buffer("B", {K, N}, a_input);
+    buffer* bC = p.add_buffer("C", {M, N}, a_output);
+    A->store_in(bA);
+    B->store_in(bB);
+    C->store_in(bC);
+    S->store_in(bC, {i, j});
+    
+    p.statements = {S};
+}
+
+static void build_jacobi_2d(KernelProgram& p) {
+    const int N = 1000, T = 20;
+    var t("t", 0, T), i("i", 2, N - 1), j("j", 2, N - 1);
+    var ii("ii", 0, N), jj("jj", 0, N);
+    
+    input* a = new input("a_in", {ii, jj}, p_float64);
+    input* b = new input("b_in", {ii, jj}, p_float64);
+    computation* S1 = new computation("S1", {t, i, j},
+        expr(0.2) * ((*a)(i, j) + (*a)(i, j - 1) + (*a)(i, j + 1) +
+                     (*a)(i + 1, j) + (*a)(i - 1, j)));
+    computation* S2 = new computation("S2", {t, i, j}, (*b)(i, j));
+    S1->then(*S2, t);
+    
+    buffer* ba = p.add_buffer("a", {N, N}, a_output);
+    buffer* bb = p.add_buffer("b", {N, N}, a_output);
+    a->store_in(ba);
+    b->store_in(bb);
+    S1->store_in(bb, {i, j});
+    S2->store_in(ba, {i, j});
+    
+    p.statements = {S1, S2};
+}
+
+static void build_fdtd_2d(KernelProgram& p) {
+    const int TMAX = 20, NX = 1000, NY = 1000;
+    var t("t", 0, TMAX);
+    var i0("i", 0, NX), i1("i", 1, NX), j0("j", 0, NY), j1("j", 1, NY);
+    var xi("xi", 0, NX + 1), yj("yj", 0, NY + 1);
+    
+    input* ex = new input("ex_in", {xi, yj}, p_float64);
+    input* ey = new input("ey_in", {xi, yj}, p_float64);
+    input* hz = new input("hz_in", {xi, yj}, p_float64);
+    
+    computation* S1 = new computation("S1", {t, j0}, cast(p_float64, t));
+    computation* S2 = new computation("S2", {t, i1, j0},
+        (*ey)(i1, j0) - expr(0.5) * ((*hz)(i1, j0) - (*hz)(i1 - 1, j0)));
+    computation* S3 = new computation("S3", {t, i0, j1},
+        (*ex)(i0, j1) - expr(0.5) * ((*hz)(i0, j1) - (*hz)(i0, j1 - 1)));
+    computation* S4 = new computation("S4", {t, i0, j0},
+        (*hz)(i0, j0) - expr(0.7) * ((*ex)(i0, j0 + 1) - (*ex)(i0, j0) +
+                                     (*ey)(i0 + 1, j0) - (*ey)(i0, j0)));
+    S1->then(*S2, t).then(*S3, t).then(*S4, t);
+    
+    buffer* bex = p.add_buffer("ex", {NX, NY + 1}, a_output);
+    buffer* bey = p.add_buffer("ey", {NX + 1, NY}, a_output);
+    buffer* bhz = p.add_buffer("hz", {NX, NY}, a_output);
+    ex->store_in(bex);
+    ey->store_in(bey);
+    hz->store_in(bhz);
+    S1->store_in(bey, {expr(0), j0});
+    S2->store_in(bey, {i1, j0});
+    S3->store_in(bex, {i0, j1});
+    S4->store_in(bhz, {i0, j0});
+    
+    p.statements = {S1, S2, S3, S4};
+}
+
+static void build_lu(KernelProgram& p) {
+    const int N = 512;
+    var k("k"), i("i"), j("j");
+    var ii("ii", 0, N), jj("jj", 0, N);
+    std::string n = std::to_string(N);
+    function* fct = global::get_implicit_function();
+    
+    input* a = new input("a_in", {ii, jj}, p_float64);
+    computation* S1 = new computation(
+        "{S1[k,j]: 0<=k<" + n + " and k+1<=j<" + n + "}",
+        (*a)(k, j) / (*a)(k, k), true, p_float64, fct);
+    computation* S2 = new computation(
+        "{S2[k,i,j]: 0<=k<" + n + " and k+1<=i<" + n + " and k+1<=j<" + n + "}",
+        (*a)(i, j) - (*a)(i, k) * (*a)(k, j), true, p_float64, fct);
+    S1->then(*S2, 0);
+    
+    buffer* ba = p.add_buffer("a", {N, N}, a_output);
+    a->store_in(ba);
+    S1->store_in(ba, {k, j});
+    S2->store_in(ba, {i, j});
+    
+    p.statements = {S1, S2};
+}
+
+static void build_seidel(KernelProgram& p) {
+    const int N = 1000, T = 20;
+    var t("t", 0, T), i("i", 1, N - 1), j("j", 1, N - 1);
+    var ii("ii", 0, N), jj("jj", 0, N);
+    
+    input* a = new input("a_in", {ii, jj}, p_float64);
+    computation* S = new computation("S", {t, i, j},
+        ((*a)(i - 1, j - 1) + (*a)(i - 1, j) + (*a)(i - 1, j + 1) +
+         (*a)(i, j - 1) + (*a)(i, j) + (*a)(i, j + 1) +
+         (*a)(i + 1, j - 1) + (*a)(i + 1, j) + (*a)(i + 1, j + 1)) / expr(9.0));
+    
+    buffer* ba = p.add_buffer("a", {N, N}, a_output);
+    a->store_in(ba);
+    S->store_in(ba, {i, j});
+    
+    p.statements = {S};
+}
+
+static void build_heat_2d(KernelProgram& p) {
+    const int N = 1000, T = 20;
+    var t("t", 0, T), i("i", 1, N + 1), j("j", 1, N + 1);
+    var tt("tt", 0, 2), ii("ii", 0, N + 2), jj("jj", 0, N + 2);
+    
+    input* A = new input("A_in", {tt, ii, jj}, p_float64);
+    expr cur = t % 2;
+    expr c = (*A)(cur, i, j);
+    computation* S = new computation("S", {t, i, j},
+        expr(0.125) * ((*A)(cur, i + 1, j) - expr(2.0) * c + (*A)(cur, i - 1, j)) +
+        expr(0.125) * ((*A)(cur, i, j + 1) - expr(2.0) * c + (*A)(cur, i, j - 1)) + c);
+    
+    buffer* bA = p.add_buffer("A", {2, N + 2, N + 2}, a_output);
+    A->store_in(bA);
+    S->store_in(bA, {(t + 1) % 2, i, j});
+    
+    p.statements = {S};
+}
+
+static void build_heat_3d(KernelProgram& p) {
+    const int N = 100, T = 20;
+    var t("t", 0, T - 1), i("i", 1, N + 1), j("j", 1, N + 1), k("k", 1, N + 1);
+    var tt("tt", 0, 2), ii("ii", 0, N + 2), jj("jj", 0, N + 2), kk("kk", 0, N + 2);
+    
+    input* A = new input("A_in", {tt, ii, jj, kk}, p_float64);
+    expr cur = t % 2;
+    expr c = (*A)(cur, i, j, k);
+    computation* S = new computation("S", {t, i, j, k},
+        expr(0.125) * ((*A)(cur, i + 1, j, k) - expr(2.0) * c + (*A)(cur, i - 1, j, k)) +
+        expr(0.125) * ((*A)(cur, i, j + 1, k) - expr(2.0) * c + (*A)(cur, i, j - 1, k)) +
+        expr(0.125) * ((*A)(cur, i, j, k - 1) - expr(2.0) * c + (*A)(cur, i, j, k + 1)) + c);
+    
+    buffer* bA = p.add_buffer("A", {2, N + 2, N + 2, N + 2}, a_output);
+    A->store_in(bA);
+    S->store_in(bA, {(t + 1) % 2, i, j, k});
+    
+    p.statements = {S};
+}
+
+static void build_doitgen(KernelProgram& p) {
+    const int N = 64;
+    var r("r", 0, N), q("q", 0, N), pp("p", 0, N), s("s", 0, N);
+    var x("x", 0, N), y("y", 0, N), z("z", 0, N);
+    
+    input* A = new input("A_in", {x, y, z}, p_float64);
+    input* C4 = new input("C4_in", {x, y}, p_float64);
+    input* sum = new input("sum_in", {x, y, z}, p_float64);
+    computation* S1 = new computation("S1", {r, q, pp}, expr(0.0));
+    computation* S2 = new computation("S2", {r, q, pp, s},
+        (*sum)(r, q, pp) + (*A)(r, q, s) * (*C4)(s, pp));
+    computation* S3 = new computation("S3", {r, q, pp}, (*sum)(r, q, pp));
+    S1->then(*S2, pp).then(*S3, q);
+    
+    buffer* bA = p.add_buffer("A", {N, N, N}, a_output);
+    buffer* bC4 = p.add_buffer("C4", {N, N}, a_input);
+    buffer* bsum = p.add_buffer("sum", {N, N, N}, a_output);
+    A->store_in(bA);
+    C4->store_in(bC4);
+    sum->store_in(bsum);
+    S1->store_in(bsum, {r, q, pp});
+    S2->store_in(bsum, {r, q, pp});
+    S3->store_in(bA, {r, q, pp});
+    
+    p.statements = {S1, S2, S3};
+}
+
+static const std::vector<Kernel>& all_kernels() {
+    static const std::vector<Kernel> kernels = {
+        {"gemm", "matmul/matmul.c", build_gemm},
+        {"jacobi-2d", "jacobi-2d-imper/jacobi-2d-imper.c", build_jacobi_2d},
+        {"fdtd-2d", "fdtd-2d/fdtd-2d.c", build_fdtd_2d},
+        {"lu", "lu/lu.c", build_lu},
+        {"seidel", "seidel/seidel.c", build_seidel},
+        {"heat-2d", "heat-2d/heat-2d.c", build_heat_2d},
+        {"heat-3d", "heat-3d/heat-3d.c", build_heat_3d},
+        {"doitgen", "doitgen/doitgen.c", build_doitgen},
+    };
+    return kernels;
+}
+
+// ============================================================================
+// Timing Wrapper (used by evaluate_by_execution)
+// ============================================================================
+
+// Tiramisu lowers with External linkage: typed entry, one buffer per argument
+static int call_kernel(void* fn, const std::vector<halide_buffer_t*>& a) {
+    typedef halide_buffer_t* B;
+    switch (a.size()) {
+        case 1: return ((int (*)(B))fn)(a[0]);
+        case 2: return ((int (*)(B, B))fn)(a[0], a[1]);
+        case 3: return ((int (*)(B, B, B))fn)(a[0], a[1], a[2]);
+        case 4: return ((int (*)(B, B, B, B))fn)(a[0], a[1], a[2], a[3]);
+        default: return -1;
+    }
+}
+
+// Prints the median time in ms (what evaluate_by_execution reads back)
+static int run_wrapper(int argc, char** argv) {
+    if (argc < 6) return 1;
+    std::string so_path = argv[2];
+    std::string fn_name = argv[3];
+    int runs = std::max(1, atoi(argv[4]));
+    
+    void* handle = dlopen(so_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        std::cout << std::numeric_limits<double>::infinity() << std::endl;
+        return 1;
+    }
+    void* fn = dlsym(handle, fn_name.c_str());
+    
+    std::vector<Halide::Buffer<double>> buffers;
+    for (int a = 5; a < argc; a++) {
+        // "512x512": outer -> inner; Halide dimensions are innermost-first
+        std::vector<int> sizes;
+        std::stringstream ss(argv[a]);
+        std::string dim;
+        while (std::getline(ss, dim, 'x')) sizes.push_back(atoi(dim.c_str()));
+        std::reverse(sizes.begin(), sizes.end());
+        
+        buffers.emplace_back(sizes);
+        double* data = buffers.back().data();
+        for (size_t e = 0; e < buffers.back().number_of_elements(); e++) {
+            data[e] = ((e % 7) + 1) * 0.125;
+        }
+    }
+    std::vector<halide_buffer_t*> args;
+    for (auto& b : buffers) args.push_back(b.raw_buffer());
+    
+    std::vector<double> samples;
+    if (fn && call_kernel(fn, args) == 0) {
+        for (int r = 0; r < runs; r++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            call_kernel(fn, args);
+            auto end = std::chrono::high_resolution_clock::now();
+            samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+    }
+    dlclose(handle);
+    
+    if (samples.empty()) {
+        std::cout << std::numeric_limits<double>::infinity() << std::endl;
+        return 1;
+    }
+    std::sort(samples.begin(), samples.end());
+    std::cout << samples[samples.size() / 2] << std::endl;
+    return 0;
+}
+
+// ============================================================================
+// Schedule Decomposition Check
+// ============================================================================
+//
+// Multiplies the skew / reversal steps of decompose_statement_schedule back
+// together (each step acts on the rows of the loop levels it names), places
+// hyperplane h at level_of_hyperplane[h] and compares with the matrix.
+
+struct DecompositionCase {
+    std::string name;
+    std::vector<std::vector<int64_t>> trans;    // Loop hyperplanes (no constant)
+    bool exact;
+};
+
+static bool check_decomposition(const DecompositionCase& test, PlutoContext* ctx) {
+    int dim = (int)test.trans.size();
+    PlutoMatrix* trans = pluto_matrix_alloc(dim, dim + 1, ctx);
+    for (int r = 0; r < dim; r++) {
+        for (int c = 0; c < dim; c++) trans->val[r][c] = test.trans[r][c];
+        trans->val[r][dim] = 0;
+    }
+    Stmt* stmt = pluto_stmt_alloc(dim, NULL, trans);
+    pluto_matrix_free(trans);
+    
+    std::vector<std::string> names;
+    for (int d = 0; d < dim; d++) {
+        names.push_back("c" + std::to_string(d));
+        stmt->iterators[d] = strdup(names[d].c_str());
+    }
+    
+    ScheduleDecomposition decomposition = decompose_statement_schedule(stmt, 0);
+    bool ok = decomposition.exact == test.exact;
+    if (ok && decomposition.exact) {
+        std::vector<std::vector<int64_t>> product(dim, std::vector<int64_t>(dim, 0));
+        for (int d = 0; d < dim; d++) product[d][d] = 1;
+        
+        for (const auto& step : decomposition.steps) {
+            std::vector<int> levels;
+            for (const auto& name : step.iterator_names) {
+                levels.push_back(std::find(names.begin(), names.end(), name) - names.begin());
+            }
+            if (step.type == TRANS_REVERSE && levels.size() == 1 && levels[0] < dim) {
+                for (auto& v : product[levels[0]]) v = -v;
+            } else if (step.type == TRANS_SKEW && levels.size() == 2 &&
+                       levels[0] < dim && levels[1] < dim && step.coefficients.size() == 4) {
+                const std::vector<int>& m = step.coefficients;
+                std::vector<int64_t> outer = product[levels[0]], inner = product[levels[1]];
+                for (int c = 0; c < dim; c++) {
+                    product[levels[0]][c] = m[0] * outer[c] + m[1] * inner[c];
+                    product[levels[1]][c] = m[2] * outer[c] + m[3] * inner[c];
+                }
+            } else {
+                ok = false;
+            }
+        }
+        for (int h = 0; h < dim && ok; h++) {
+            int level = decomposition.level_of_hyperplane[h];
+            ok = level >= 0 && level < dim && product[level] == test.trans[h];
+        }
+    }
+    
+    std::cout << "  " << std::left << std::setw(28) << test.name
+              << (decomposition.exact ? "exact, " : "not exact, ")
+              << decomposition.steps.size() << " steps: " << (ok ? "OK" : "MISMATCH") << "\n";
+    pluto_stmt_free(stmt);
+    return ok;
+}
+
+static int run_decomposition_check() {
+    const std::vector<DecompositionCase> cases = {
+        {"time-skewed stencil", {{1, 0, 0}, {1, 1, 0}, {1, 0, 1}}, true},
+        {"interchange + reversal", {{0, -1}, {1, 0}}, true},
+        {"reversal", {{1, 0, 0}, {0, -1, 0}, {0, 0, 1}}, true},
+        {"skews with coefficients > 1", {{2, 1, 0}, {1, 1, 0}, {0, 3, 1}}, true},
+        {"non-unimodular (det -2)", {{1, 1}, {1, -1}}, false},
+    };
+    
+    PlutoContext* ctx = pluto_context_alloc();
+    int failures = 0;
+    std::cout << "decompose_statement_schedule:\n";
+    for (const auto& test : cases) {
+        if (!check_decomposition(test, ctx)) failures++;
+    }
+    pluto_context_free(ctx);
+    
+    std::cout << (cases.size() - failures) << "/" << cases.size() << " cases passed\n";
+    return failures == 0 ? 0 : 1;
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+struct Options {
+    std::vector<std::string> kernels;
+    std::string output = "polybench_tuning.json";
+    std::string strategy = "optimal_neighbors";
+    int runs = 10;
+    int beam_size = 2;
+    int max_depth = 4;
+};
+
+static std::string self_path() {
+    char buf[PATH_MAX];
+    ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    if (n <= 0) return "./benchmark_polybench_tuning";
+    buf[n] = '\0';
+    return buf;
+}
+
+static double ms_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string json_number(double v) {
+    if (!(v == v) || v == std::numeric_limits<double>::infinity() || v < 0) return "null";
+    std::ostringstream out;
+    out << std::setprecision(6) << v;
+    return out.str();
+}
+
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (c == '\n') { out += "\\n"; continue; }
+        out += c;
+    }
+    return out + "\"";
+}
+
+// Tiramisu beam search with real execution (on its own copy of the program:
+// evaluate_by_execution resets the schedules, dropping the statement order)
+static std::string run_beam_search(const Kernel& kernel, KernelProgram& prog,
+                                   const Options& opts) {
+    function* fct = global::get_implicit_function();
+    std::string obj = "/tmp/pbt_" + kernel.name + "_" + std::to_string(getpid()) + ".o";
+    
+    std::string cmd = self_path() + " --wrapper " + obj + ".so " + fct->get_name() +
+                      " " + std::to_string(opts.runs);
+    for (const auto& shape : prog.shapes) {
+        std::string s;
+        for (int d : shape) s += (s.empty() ? "" : "x") + std::to_string(d);
+        cmd += " " + s;
+    }
+    
+    auto_scheduler::syntax_tree ast(fct);
+    auto_scheduler::evaluate_by_execution exec_eval(prog.arguments, obj, cmd, fct);
+    auto_scheduler::ml_model_schedules_generator scheds_gen;
+    auto_scheduler::beam_search bs(opts.beam_size, opts.max_depth, &exec_eval, &scheds_gen);
+    
+    double baseline_ms = exec_eval.evaluate(ast);
+    ast.evaluation = baseline_ms;
+    
+    auto start = std::chrono::steady_clock::now();
+    bs.search(ast);
+    double search_ms = ms_since(start);
+    
+    // Re-measure the winner with the same harness as the baseline
+    double best_ms = bs.get_best_evaluation();
+    if (bs.get_best_ast()) {
+        best_ms = exec_eval.evaluate(*bs.get_best_ast());
+    }
+    fct->reset_schedules();
+    std::remove(obj.c_str());
+    std::remove((obj + ".so").c_str());
+    
+    std::ostringstream out;
+    out << "{\"beam_size\": " << opts.beam_size
+        << ", \"max_depth\": " << opts.max_depth
+        << ", \"search_time_ms\": " << json_number(search_ms)
+        << ", \"evaluations\": " << bs.get_nb_explored_schedules()
+        << ", \"baseline_ms\": " << json_number(baseline_ms)
+        << ", \"best_ms\": " << json_number(best_ms)
+        << ", \"speedup\": " << json_number(best_ms > 0 ? baseline_ms / best_ms : -1) << "}";
+    return out.str();
+}
+
+// PLUTO-guided search: pet -> PLUTO -> HybridOptimizer
+static std::string run_bridge(const Kernel& kernel, KernelProgram& prog,
+                              const Options& opts, std::string& error) {
+    function* fct = global::get_implicit_function();
+    std::string path = std::string(PLUTO_EXAMPLES_DIR) + "/" + kernel.source;
+    
+    BridgeProfiler::instance().reset();
+    auto start = std::chrono::steady_clock::now();
+    
+    PlutoContext* ctx = pluto_context_alloc();
+    ctx->options->silent = 1;
+    ctx->options->quiet = 1;
+    
+    PlutoProg* pluto_prog = nullptr;
+    {
+        ScopedPhase phase(PHASE_PLUTO_SOLVE);
+        isl_ctx* pctx = isl_ctx_alloc_with_pet_options();
+        pet_scop* scop = pet_scop_extract_from_C_source(pctx, path.c_str(), NULL);
+        if (scop) {
+            pluto_prog = pet_to_pluto_prog(scop, pctx, ctx);
+            pet_scop_free(scop);
+        }
+        isl_ctx_free(pctx);
+    }
+    if (!pluto_prog || pluto_prog->nstmts != (int)prog.statements.size()) {
+        error = pluto_prog ? "statement count mismatch between " + kernel.source +
+                             " and the Tiramisu program"
+                           : "pet could not extract a SCoP from " + path;
+        if (pluto_prog) pluto_prog_free(pluto_prog);
+        pluto_context_free(ctx);
+        return "";
+    }
+    
+    HybridOptimizer optimizer(ctx, ctx->options, fct);
+    optimizer.set_statement_computations(prog.statements);
+    
+    // Original schedule, measured as the baseline below
+    ScheduleConfig original = optimizer.solver().pluto_prog_to_config(pluto_prog);
+    original.description = "original";
+    
+    {
+        ScopedPhase phase(PHASE_PLUTO_SOLVE);
+        pluto_auto_transform(pluto_prog);
+        pluto_compute_dep_directions(pluto_prog);
+        pluto_compute_dep_satisfaction(pluto_prog);
+    }
+    
+    HybridOptimizer::OptimizationResult result =
+        optimizer.optimize(*prog.statements[0], pluto_prog, opts.strategy);
+    double search_ms = ms_since(start);
+    
+    MeasurementResult baseline = optimizer.measure(*prog.statements[0], original, opts.runs);
+    MeasurementResult best = optimizer.measure(*prog.statements[0], result.best_config, opts.runs);
+    
+    double baseline_ms = baseline.ok ? baseline.median_ms : -1;
+    double best_ms = best.ok ? best.median_ms : -1;
+    
+    std::ostringstream out;
+    out << "{\"strategy\": " << json_string(opts.strategy)
+        << ", \"search_time_ms\": " << json_number(search_ms)
+        << ", \"evaluations\": " << result.num_evaluated
+        << ", \"candidates\": " << result.num_candidates_generated
+        << ", \"baseline_ms\": " << json_number(baseline_ms)
+        << ", \"best_ms\": " << json_number(best_ms)
+        << ", \"speedup\": " << json_number(best_ms > 0 && baseline_ms > 0 ? baseline_ms / best_ms : -1)
+        << ", \"best_schedule\": " << json_string(result.best_config.description)
+        << ", \"phases_ms\": {";
+    for (int p = 0; p < NUM_PROFILE_PHASES; p++) {
+        BridgeProfiler::PhaseStats stats =
+            BridgeProfiler::instance().phase_stats((ProfilePhase)p);
+        out << (p ? ", " : "") << json_string(profile_phase_name((ProfilePhase)p))
+            << ": " << json_number(stats.total_ms);
+    }
+    out << "}}";
+    
+    pluto_prog_free(pluto_prog);
+    pluto_context_free(ctx);
+    return out.str();
+}
+
+// Fresh Tiramisu program of the kernel with its declared statement order
+static void build_program(const Kernel& kernel, KernelProgram& prog) {
+    tiramisu::init(kernel.name);
+    kernel.build(prog);
+    global::get_implicit_function()->set_arguments(prog.arguments);
+}
+
+// Run body in a child process; returns what it produced ("" if it died)
+static std::string run_isolated(const std::function<std::string()>& body) {
+    int fds[2];
+    if (pipe(fds) != 0) return "";
+    
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        std::string out = body();
+        ssize_t unused = write(fds[1], out.data(), out.size());
+        (void)unused;
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    
+    std::string out;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0) out.append(buf, n);
+    close(fds[0]);
+    
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return out;
+}
+
+static std::string run_kernel(const Kernel& kernel, const Options& opts) {
+    std::string beam = run_isolated([&]() {
+        KernelProgram prog;
+        build_program(kernel, prog);
+        return run_beam_search(kernel, prog, opts);
+    });
+    
+    // "J<json>" or "E<error>"
+    std::string bridge_out = run_isolated([&]() {
+        KernelProgram prog;
+        build_program(kernel, prog);
+        std::string error;
+        std::string json = run_bridge(kernel, prog, opts, error);
+        return json.empty() ? "E" + error : "J" + json;
+    });
+    
+    std::string bridge, error;
+    if (bridge_out.empty()) {
+        error = "bridge process failed";
+    } else if (bridge_out[0] == 'J') {
+        bridge = bridge_out.substr(1);
+    } else {
+        error = bridge_out.substr(1);
+    }
+    if (beam.empty()) {
+        error += std::string(error.empty() ? "" : "; ") + "beam search process failed";
+    }
+    
+    std::ostringstream out;
+    out << "{\"kernel\": " << json_string(kernel.name)
+        << ", \"source\": " << json_string(kernel.source)
+        << ", \"bridge\": " << (bridge.empty() ? "null" : bridge)
+        << ", \"beam_search\": " << (beam.empty() ? "null" : beam);
+    if (!error.empty()) out << ", \"error\": " << json_string(error);
+    out << "}";
+    return out.str();
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--wrapper") {
+        return run_wrapper(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check-decomposition") {
+        return run_decomposition_check();
+    }
+    
+    Options opts;
+    for (int a = 1; a + 1 < argc; a += 2) {
+        std::string flag = argv[a], value = argv[a + 1];
+        if (flag == "--kernels") {
+            std::stringstream ss(value);
+            std::string k;
+            while (std::getline(ss, k, ',')) opts.kernels.push_back(k);
+        } else if (flag == "--output") {
+            opts.output = value;
+        } else if (flag == "--strategy") {
+            opts.strategy = value;
+        } else if (flag == "--runs") {
+            opts.runs = std::max(1, atoi(value.c_str()));
+        } else if (flag == "--beam-size") {
+            opts.beam_size = std::max(1, atoi(value.c_str()));
+        } else if (flag == "--max-depth") {
+            opts.max_depth = std::max(1, atoi(value.c_str()));
+        } else {
+            std::cerr << "Unknown option " << flag << "\n";
+            return 1;
+        }
+    }
+    
+    std::vector<std::string> results;
+    for (const auto& kernel : all_kernels()) {
+        if (!opts.kernels.empty() &&
+            std::find(opts.kernels.begin(), opts.kernels.end(), kernel.name) == opts.kernels.end()) {
+            continue;
+        }
+        std::cout << "Kernel " << kernel.name << "..." << std::flush;
+        results.push_back(run_kernel(kernel, opts));
+        std::cout << " done\n";
+    }
+    
+    std::ofstream out(opts.output);
+    out << "{\n  \"benchmark\": \"polybench_tuning\",\n"
+        << "  \"cores\": " << sysconf(_SC_NPROCESSORS_ONLN) << ",\n"
+        << "  \"runs\": " << opts.runs << ",\n"
+        << "  \"kernels\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        out << (i ? ",\n    " : "\n    ") << results[i];
+    }
+    out << "\n  ]\n}\n";
+    
+    std::cout << "Results written to " << opts.output << "\n";
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include "bridge_profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace pluto_tiramisu {
+
+const char* profile_phase_name(ProfilePhase phase) {
+    switch (phase) {
+        case PHASE_PLUTO_SOLVE: return "pluto_solve";
+        case PHASE_CANDIDATE_GENERATION: return "candidate_generation";
+        case PHASE_FILTERING: return "filtering";
+        case PHASE_LEGALITY: return "legality";
+        case PHASE_CODEGEN: return "codegen";
+        case PHASE_COMPILE: return "compile";
+        case PHASE_RUN: return "run";
+        default: return "unknown";
+    }
+}
+
+// Stream with no buffer: every insertion fails immediately without formatting
+static std::ostream& null_stream() {
+    static std::ostream stream(nullptr);
+    return stream;
+}
+
+BridgeProfiler::BridgeProfiler()
+    : log_level_(LOG_QUIET), enabled_(true), max_trace_events_(100000),
+      epoch_(std::chrono::steady_clock::now()), dropped_events_(0) {
+    const char* env = std::getenv("PLUTO_TIRAMISU_VERBOSE");
+    if (env && *env && std::string(env) != "0") {
+        log_level_ = LOG_VERBOSE;
+    }
+}
+
+BridgeProfiler& BridgeProfiler::instance() {
+    static BridgeProfiler profiler;
+    return profiler;
+}
+
+std::ostream& BridgeProfiler::log() {
+    return verbose() ? std::cout : null_stream();
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void BridgeProfiler::record(
+    ProfilePhase phase,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end
+) {
+    if (!enabled_ || phase < 0 || phase >= NUM_PROFILE_PHASES) return;
+    
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    double start_us = std::chrono::duration<double, std::micro>(start - epoch_).count();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    PhaseStats& stats = phases_[phase];
+    stats.calls++;
+    stats.total_ms += ms;
+    stats.max_ms = std::max(stats.max_ms, ms);
+    
+    if (events_.size() < max_trace_events_) {
+        events_.push_back(TraceEvent{phase, start_us, ms * 1000.0});
+    } else {
+        dropped_events_++;
+    }
+}
+
+void BridgeProfiler::count(const std::string& counter, int64_t delta) {
+    if (!enabled_) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_[counter] += delta;
+}
+
+void BridgeProfiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& stats : phases_) {
+        stats = PhaseStats();
+    }
+    counters_.clear();
+    events_.clear();
+    dropped_events_ = 0;
+    epoch_ = std::chrono::steady_clock::now();
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+BridgeProfiler::PhaseStats BridgeProfiler::phase_stats(ProfilePhase phase) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (phase < 0 || phase >= NUM_PROFILE_PHASES) return PhaseStats();
+    return phases_[phase];
+}
+
+int64_t BridgeProfiler::counter(const std::string& counter) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = counters_.find(counter);
+    return it == counters_.end() ? 0 : it->second;
+}
+
+std::map<std::string, int64_t> BridgeProfiler::counters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_;
+}
+
+std::string BridgeProfiler::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // Phases nest (candidate generation includes the PLUTO solves and
+    // legality checks it triggers), so shares are of wall time, not a sum
+    double wall_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - epoch_).count();
+    
+    std::ostringstream out;
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-22s %8s %12s %12s %7s\n",
+                  "phase", "calls", "total_ms", "max_ms", "wall");
+    out << line;
+    for (int p = 0; p < NUM_PROFILE_PHASES; p++) {
+        const PhaseStats& stats = phases_[p];
+        std::snprintf(line, sizeof(line), "%-22s %8lld %12.3f %12.3f %6.1f%%\n",
+                      profile_phase_name((ProfilePhase)p), (long long)stats.calls,
+                      stats.total_ms, stats.max_ms,
+                      wall_ms > 0 ? 100.0 * stats.total_ms / wall_ms : 0.0);
+        out << line;
+    }
+    
+    if (!counters_.empty()) {
+        out << "\n";
+        for (const auto& c : counters_) {
+            std::snprintf(line, sizeof(line), "%-32s %12lld\n",
+                          c.first.c_str(), (long long)c.second);
+            out << line;
+        }
+    }
+    return out.str();
+}
+
+static std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string BridgeProfiler::to_json() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    std::ostringstream out;
+    out << "{\n  \"traceEvents\": [";
+    for (size_t i = 0; i < events_.size(); i++) {
+        const TraceEvent& e = events_[i];
+        out << (i ? ",\n" : "\n")
+            << "    {\"name\": \"" << profile_phase_name(e.phase) << "\", "
+            << "\"cat\": \"bridge\", \"ph\": \"X\", "
+            << "\"ts\": " << e.start_us << ", \"dur\": " << e.dur_us << ", "
+            << "\"pid\": 0, \"tid\": 0}";
+    }
+    out << "\n  ],\n";
+    
+    out << "  \"phases\": {";
+    for (int p = 0; p < NUM_PROFILE_PHASES; p++) {
+        const PhaseStats& stats = phases_[p];
+        out << (p ? ",\n" : "\n")
+            << "    \"" << profile_phase_name((ProfilePhase)p) << "\": {"
+            << "\"calls\": " << stats.calls << ", "
+            << "\"total_ms\": " << stats.total_ms << ", "
+            << "\"max_ms\": " << stats.max_ms << "}";
+    }
+    out << "\n  },\n";
+    
+    out << "  \"counters\": {";
+    bool first = true;
+    for (const auto& c : counters_) {
+        out << (first ? "\n" : ",\n")
+            << "    \"" << json_escape(c.first) << "\": " << c.second;
+        first = false;
+    }
+    out << "\n  },\n";
+    out << "  \"dropped_events\": " << dropped_events_ << "\n}\n";
+    return out.str();
+}
+
+bool BridgeProfiler::write_json(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+    file << to_json();
+    return (bool)file;
+}
+
+} // namespace pluto_tiramisu
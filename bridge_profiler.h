@@ -0,0 +1,130 @@
+#ifndef BRIDGE_PROFILER_H
+#define BRIDGE_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// Bridge Profiler - Per-phase timers, counters and quiet-by-default logging
+// ============================================================================
+//
+// One process-wide instance. Phases are timed with ScopedPhase, counters are
+// bumped with count(). The result is available as a text report or as a JSON
+// trace (Chrome trace-event format, plus a summary object).
+//
+// Progress output of the bridge goes through bridge_log(), which discards
+// everything unless the log level is LOG_VERBOSE (or PLUTO_TIRAMISU_VERBOSE
+// is set in the environment). Errors still go to std::cerr.
+
+enum ProfilePhase {
+    PHASE_PLUTO_SOLVE,
+    PHASE_CANDIDATE_GENERATION,
+    PHASE_FILTERING,
+    PHASE_LEGALITY,
+    PHASE_CODEGEN,
+    PHASE_COMPILE,
+    PHASE_RUN,
+    NUM_PROFILE_PHASES
+};
+
+const char* profile_phase_name(ProfilePhase phase);
+
+enum LogLevel {
+    LOG_QUIET,      // No progress output (default)
+    LOG_VERBOSE     // Banners, per-candidate tables
+};
+
+class BridgeProfiler {
+public:
+    struct PhaseStats {
+        int64_t calls;
+        double total_ms;
+        double max_ms;
+        
+        PhaseStats() : calls(0), total_ms(0.0), max_ms(0.0) {}
+    };
+    
+    struct TraceEvent {
+        ProfilePhase phase;
+        double start_us;    // Since the profiler epoch
+        double dur_us;
+    };
+    
+    static BridgeProfiler& instance();
+    
+    // Logging
+    void set_log_level(LogLevel level) { log_level_ = level; }
+    LogLevel log_level() const { return log_level_; }
+    bool verbose() const { return log_level_ == LOG_VERBOSE; }
+    std::ostream& log();
+    
+    // Profiling (enabled by default; timers are a few clock reads)
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+    
+    // Keep at most this many trace events (phase totals are always exact)
+    void set_max_trace_events(size_t n) { max_trace_events_ = n; }
+    
+    void record(ProfilePhase phase,
+                std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end);
+    void count(const std::string& counter, int64_t delta = 1);
+    void reset();
+    
+    // In-memory report
+    PhaseStats phase_stats(ProfilePhase phase) const;
+    int64_t counter(const std::string& counter) const;
+    std::map<std::string, int64_t> counters() const;
+    std::string report() const;
+    
+    // JSON trace
+    std::string to_json() const;
+    bool write_json(const std::string& path) const;
+
+private:
+    BridgeProfiler();
+    
+    mutable std::mutex mutex_;
+    std::atomic<LogLevel> log_level_;
+    std::atomic<bool> enabled_;
+    size_t max_trace_events_;
+    std::chrono::steady_clock::time_point epoch_;
+    PhaseStats phases_[NUM_PROFILE_PHASES];
+    std::map<std::string, int64_t> counters_;
+    std::vector<TraceEvent> events_;
+    int64_t dropped_events_;
+};
+
+// Times the enclosing scope as one occurrence of phase
+class ScopedPhase {
+public:
+    explicit ScopedPhase(ProfilePhase phase)
+        : phase_(phase), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedPhase() {
+        BridgeProfiler::instance().record(phase_, start_, std::chrono::steady_clock::now());
+    }
+    
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    ProfilePhase phase_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Progress output stream of the bridge (discarded unless verbose)
+inline std::ostream& bridge_log() {
+    return BridgeProfiler::instance().log();
+}
+
+} // namespace pluto_tiramisu
+
+#endif // BRIDGE_PROFILER_H
@@ -0,0 +1,310 @@
+#include "candidate_batch.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// IteratorTable
+// ============================================================================
+
+uint8_t IteratorTable::intern(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
+    if (names_.size() >= kNoLoop) return kNoLoop;
+    
+    uint8_t id = (uint8_t)names_.size();
+    names_.push_back(name);
+    ids_[name] = id;
+    return id;
+}
+
+uint8_t IteratorTable::find(const std::string& name) const {
+    auto it = ids_.find(name);
+    return it == ids_.end() ? kNoLoop : it->second;
+}
+
+// ============================================================================
+// CandidateBatch
+// ============================================================================
+
+void CandidateBatch::clear() {
+    order_kind.clear();
+    depth.clear();
+    innermost.clear();
+    num_tiles.clear();
+    loop_order.clear();
+    tile_loop.clear();
+    tile_size.clear();
+    coalescing_score.clear();
+    coalesced.clear();
+    lines_per_iteration.clear();
+    conflict_way.clear();
+}
+
+void CandidateBatch::reserve(size_t n) {
+    order_kind.reserve(n);
+    depth.reserve(n);
+    innermost.reserve(n);
+    num_tiles.reserve(n);
+    loop_order.reserve(n * kMaxLoops);
+    tile_loop.reserve(n * kMaxLoops);
+    tile_size.reserve(n * kMaxLoops);
+}
+
+int CandidateBatch::add(const ScheduleConfig& config) {
+    // Same innermost-loop rule as the scalar scores: the last single-iterator
+    // interchange, otherwise the last iterator of the last transformation
+    // Loop ids go straight into fixed-size arrays: no per-candidate allocation
+    // (except for the rare diamond tile, whose point-loop names are derived)
+    OrderKind kind = ORDER_NONE;
+    uint8_t order_ids[kMaxLoops];
+    int order_depth = 0;
+    const Transformation* diamond = nullptr;
+    for (const auto& trans : config.transformations) {
+        if (trans.type == TRANS_INTERCHANGE && trans.iterator_names.size() == 1) {
+            if (order_depth == kMaxLoops) return -1;
+            order_ids[order_depth++] = iterators.intern(trans.iterator_names[0]);
+        }
+        if (trans.type == TRANS_DIAMOND_TILE && trans.statement_id == 0) diamond = &trans;
+    }
+    
+    uint8_t inner = IteratorTable::kNoLoop;
+    if (order_depth > 0) {
+        kind = ORDER_EXPLICIT;
+        inner = order_ids[order_depth - 1];
+    } else if (diamond) {
+        // Strides of a diamond tile's point loops use the original accesses
+        kind = ORDER_EXPLICIT;
+        inner = iterators.intern(diamond_loop_names(*diamond).back());
+    } else if (!config.transformations.empty()) {
+        kind = ORDER_PLUTO;
+        const std::vector<std::string>& names = config.transformations.back().iterator_names;
+        if (!names.empty()) inner = iterators.intern(names.back());
+        if (!config.statements.empty()) {
+            for (const auto& name : config.statements[0].loop_order) {
+                if (order_depth == kMaxLoops) return -1;
+                order_ids[order_depth++] = iterators.intern(name);
+            }
+        }
+        if (!names.empty() && inner == IteratorTable::kNoLoop) return -1;
+    }
+    if (kind == ORDER_EXPLICIT && inner == IteratorTable::kNoLoop) return -1;
+    
+    // One slot per tiled loop (last size wins, as in the conflict analysers)
+    std::pair<uint8_t, uint16_t> tiles[kMaxLoops];
+    int ntiles = 0;
+    for (const auto& ts : config.tile_sizes) {
+        if (ts.size < 0 || ts.size > 0xFFFF) return -1;
+        uint8_t id = iterators.intern(ts.loop_name);
+        if (id == IteratorTable::kNoLoop) return -1;
+        int slot = 0;
+        while (slot < ntiles && tiles[slot].first != id) slot++;
+        if (slot == kMaxLoops) return -1;
+        if (slot == ntiles) ntiles++;
+        tiles[slot] = std::make_pair(id, (uint16_t)ts.size);
+    }
+    
+    return append(kind, order_ids, order_depth, inner, tiles, ntiles);
+}
+
+int CandidateBatch::append(OrderKind kind, const uint8_t* order, int order_depth,
+                           uint8_t inner, std::pair<uint8_t, uint16_t>* tiles, int ntiles) {
+    if (order_depth > kMaxLoops || ntiles > kMaxLoops) return -1;
+    for (int d = 0; d < order_depth; d++) {
+        if (order[d] == IteratorTable::kNoLoop) return -1;
+    }
+    for (int t = 0; t < ntiles; t++) {
+        if (tiles[t].first == IteratorTable::kNoLoop) return -1;
+    }
+    std::sort(tiles, tiles + ntiles);
+    
+    int index = (int)size();
+    order_kind.push_back(kind);
+    depth.push_back((uint8_t)order_depth);
+    innermost.push_back(inner);
+    num_tiles.push_back((uint8_t)ntiles);
+    for (int d = 0; d < kMaxLoops; d++) {
+        loop_order.push_back(d < order_depth ? order[d] : IteratorTable::kNoLoop);
+        tile_loop.push_back(d < ntiles ? tiles[d].first : IteratorTable::kNoLoop);
+        tile_size.push_back(d < ntiles ? tiles[d].second : 0);
+    }
+    return index;
+}
+
+// ============================================================================
+// Batch Kernels
+// ============================================================================
+//
+// Plain loops over contiguous arrays without aliasing; with -O3 (and
+// -fopenmp-simd for the pragmas) the compiler emits vector gathers for the
+// target ISA.
+
+template <typename T>
+static void gather(const int32_t* __restrict index, const T* __restrict table,
+                   T* __restrict out, size_t n) {
+#pragma omp simd
+    for (size_t c = 0; c < n; c++) {
+        out[c] = table[index[c]];
+    }
+}
+
+// Column 0: no transformations; then one block of loops per order kind,
+// the last entry of each block being the unnamed loop
+static void compute_columns(const uint8_t* __restrict kind,
+                            const uint8_t* __restrict inner,
+                            int32_t* __restrict column,
+                            size_t n, int32_t loops) {
+#pragma omp simd
+    for (size_t c = 0; c < n; c++) {
+        int32_t loop = inner[c] == IteratorTable::kNoLoop ? loops - 1 : (int32_t)inner[c];
+        int32_t block = kind[c] == CandidateBatch::ORDER_PLUTO ? loops : 0;
+        column[c] = kind[c] == CandidateBatch::ORDER_NONE ? 0 : 1 + block + loop;
+    }
+}
+
+// ============================================================================
+// CandidateBatchScorer
+// ============================================================================
+
+// Smallest config with the column's innermost loop and order kind; the
+// scalar scores of this config are the scores of every candidate in it
+ScheduleConfig CandidateBatchScorer::column_config(const CandidateBatch& batch,
+                                                   size_t column) const {
+    ScheduleConfig config;
+    if (column == 0) return config;
+    
+    size_t loop = (column - 1) % table_loops_;
+    bool pluto = (column - 1) >= table_loops_;
+    
+    Transformation trans(pluto ? TRANS_TILE : TRANS_INTERCHANGE);
+    trans.iterator_names.push_back(loop + 1 < table_loops_ ? batch.iterators.name(loop) : "");
+    config.transformations.push_back(trans);
+    return config;
+}
+
+void CandidateBatchScorer::build_tables(const CandidateBatch& batch) {
+    table_loops_ = batch.iterators.size() + 1;
+    size_t num_columns = 1 + 2 * table_loops_;
+    
+    const std::vector<AccessPattern>& patterns = solver_.get_access_patterns();
+    coalescing_table_.assign(num_columns, 0.0);
+    coalesced_table_.assign(num_columns, 0);
+    lines_table_.assign(num_columns, 0.0f);
+    
+    for (size_t col = 0; col < num_columns; col++) {
+        ScheduleConfig config = column_config(batch, col);
+        coalescing_table_[col] = solver_.compute_weighted_coalescing_score(config, patterns);
+        coalesced_table_[col] = solver_.satisfies_coalescing_constraint(config) ? 1 : 0;
+        
+        double lines = 0.0;
+        for (const auto& pattern : patterns) {
+            int64_t bytes = solver_.compute_stride_for_pattern(config, pattern) *
+                            (int64_t)pattern.element_size;
+            lines += pattern.access_frequency *
+                     (double)std::min(bytes, line_bytes_) / (double)line_bytes_;
+        }
+        lines_table_[col] = (float)lines;
+    }
+    
+    size_t n = batch.size();
+    columns_.resize(n);
+    compute_columns(batch.order_kind.data(), batch.innermost.data(), columns_.data(),
+                    n, (int32_t)table_loops_);
+}
+
+void CandidateBatchScorer::score(CandidateBatch& batch) {
+    build_tables(batch);
+    size_t n = batch.size();
+    
+    batch.coalescing_score.resize(n);
+    batch.coalesced.resize(n);
+    batch.lines_per_iteration.resize(n);
+    gather(columns_.data(), coalescing_table_.data(), batch.coalescing_score.data(), n);
+    gather(columns_.data(), coalesced_table_.data(), batch.coalesced.data(), n);
+    gather(columns_.data(), lines_table_.data(), batch.lines_per_iteration.data(), n);
+    
+    score_conflicts(batch);
+}
+
+void CandidateBatchScorer::score_coalescing(CandidateBatch& batch) {
+    build_tables(batch);
+    size_t n = batch.size();
+    batch.coalescing_score.resize(n);
+    batch.coalesced.resize(n);
+    gather(columns_.data(), coalescing_table_.data(), batch.coalescing_score.data(), n);
+    gather(columns_.data(), coalesced_table_.data(), batch.coalesced.data(), n);
+}
+
+void CandidateBatchScorer::score_strides(CandidateBatch& batch) {
+    build_tables(batch);
+    size_t n = batch.size();
+    batch.lines_per_iteration.resize(n);
+    gather(columns_.data(), lines_table_.data(), batch.lines_per_iteration.data(), n);
+}
+
+// Tile rows of a batch compared and hashed in place, so the row table can be
+// keyed by the index of the first candidate with that row
+namespace {
+
+struct TileRowHash {
+    const CandidateBatch* batch;
+    size_t operator()(int32_t c) const {
+        const int width = CandidateBatch::kMaxLoops;
+        uint64_t h = 1469598103934665603ULL;  // FNV-1a
+        for (int t = 0; t < width; t++) {
+            h = (h ^ batch->tile_loop[c * width + t]) * 1099511628211ULL;
+            h = (h ^ batch->tile_size[c * width + t]) * 1099511628211ULL;
+        }
+        return (size_t)h;
+    }
+};
+
+struct TileRowEqual {
+    const CandidateBatch* batch;
+    bool operator()(int32_t a, int32_t b) const {
+        const int width = CandidateBatch::kMaxLoops;
+        return std::memcmp(&batch->tile_loop[a * width], &batch->tile_loop[b * width],
+                           width * sizeof(uint8_t)) == 0 &&
+               std::memcmp(&batch->tile_size[a * width], &batch->tile_size[b * width],
+                           width * sizeof(uint16_t)) == 0;
+    }
+};
+
+} // namespace
+
+void CandidateBatchScorer::score_conflicts(CandidateBatch& batch) {
+    // Conflict degrees depend on the tile vector only: run the analyser once
+    // per distinct tile row, then gather
+    const int width = CandidateBatch::kMaxLoops;
+    size_t n = batch.size();
+    
+    std::unordered_map<int32_t, int32_t, TileRowHash, TileRowEqual> tile_rows(
+        16, TileRowHash{&batch}, TileRowEqual{&batch});
+    std::vector<int32_t> row_of(n);
+    std::vector<int32_t> row_way;
+    
+    for (size_t c = 0; c < n; c++) {
+        auto it = tile_rows.find((int32_t)c);
+        if (it == tile_rows.end()) {
+            ScheduleConfig config;
+            for (int t = 0; t < batch.num_tiles[c]; t++) {
+                ScheduleConfig::TileSize ts;
+                ts.loop_name = batch.iterators.name(batch.tile_loop[c * width + t]);
+                ts.size = batch.tile_size[c * width + t];
+                config.tile_sizes.push_back(ts);
+            }
+            int way = 1;
+            solver_.check_bank_conflict(config, way);
+            it = tile_rows.emplace((int32_t)c, (int32_t)row_way.size()).first;
+            row_way.push_back(way);
+        }
+        row_of[c] = it->second;
+    }
+    
+    batch.conflict_way.resize(n);
+    gather(row_of.data(), row_way.data(), batch.conflict_way.data(), n);
+}
+
+} // namespace pluto_tiramisu
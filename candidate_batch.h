@@ -0,0 +1,128 @@
+#ifndef CANDIDATE_BATCH_H
+#define CANDIDATE_BATCH_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "pluto_guided_search.h"
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// Candidate Batch - Struct-of-arrays candidates for batch scoring
+// ============================================================================
+//
+// A ScheduleConfig is a tree of vectors, strings and a map; scoring one means
+// string compares against every access pattern. The batch keeps only what the
+// memory-system scores depend on, as flat arrays indexed by candidate:
+// interned loop ids for the loop order, the innermost loop, and the tile
+// sizes packed as (loop id, size) slots.
+//
+// Coalescing and stride scores of a candidate depend only on its innermost
+// loop (and on whether the loop order is explicit), so they are tabulated
+// once per loop and gathered for the whole batch. Conflict degrees depend
+// only on the tile sizes and are computed once per distinct tile vector.
+
+// Dense ids for loop names (at most 255; kNoLoop is reserved)
+class IteratorTable {
+public:
+    static constexpr uint8_t kNoLoop = 255;
+    
+    // Id of name, adding it if new; kNoLoop when the table is full
+    uint8_t intern(const std::string& name);
+    
+    // Id of name or kNoLoop
+    uint8_t find(const std::string& name) const;
+    
+    const std::string& name(uint8_t id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+
+private:
+    std::vector<std::string> names_;
+    std::map<std::string, uint8_t> ids_;
+};
+
+class CandidateBatch {
+public:
+    static constexpr int kMaxLoops = 8;  // Loop-order and tile slots per candidate
+    
+    // How the innermost loop of a candidate was determined
+    enum OrderKind : uint8_t {
+        ORDER_NONE,       // No transformations
+        ORDER_EXPLICIT,   // Single-iterator interchanges (enumerated orders)
+        ORDER_PLUTO       // PLUTO's schedule; strides use transformed accesses
+    };
+    
+    // Append a config; returns its index, or -1 if it does not fit the
+    // fixed-width layout (too many loops / tiles, tile size > 65535)
+    int add(const ScheduleConfig& config);
+    
+    // Append already interned columns (generators that know their loop ids
+    // skip the config); tiles are sorted in place. Same -1 rule as add()
+    int append(OrderKind kind, const uint8_t* order, int order_depth, uint8_t inner,
+               std::pair<uint8_t, uint16_t>* tiles, int ntiles);
+    
+    void clear();
+    void reserve(size_t n);
+    size_t size() const { return order_kind.size(); }
+    
+    IteratorTable iterators;
+    
+    // Per candidate
+    std::vector<uint8_t> order_kind;
+    std::vector<uint8_t> depth;           // Used entries of loop_order
+    std::vector<uint8_t> innermost;       // Loop id (kNoLoop: unnamed)
+    std::vector<uint8_t> num_tiles;       // Used tile slots
+    
+    // Per candidate x kMaxLoops, unused slots hold kNoLoop / 0
+    std::vector<uint8_t> loop_order;      // Outer -> inner
+    std::vector<uint8_t> tile_loop;       // Sorted by loop id
+    std::vector<uint16_t> tile_size;
+    
+    // Scores, filled by CandidateBatchScorer::score
+    std::vector<double> coalescing_score;     // compute_weighted_coalescing_score
+    std::vector<uint8_t> coalesced;           // satisfies_coalescing_constraint
+    std::vector<float> lines_per_iteration;   // Cache lines per innermost step
+    std::vector<int32_t> conflict_way;        // check_bank_conflict degree
+};
+
+// ============================================================================
+// Candidate Batch Scorer
+// ============================================================================
+
+class CandidateBatchScorer {
+public:
+    // Scores against the solver's access patterns and conflict analyser;
+    // the solver must outlive the scorer
+    explicit CandidateBatchScorer(PlutoConstraintSolver& solver,
+                                  int64_t line_bytes = 64)
+        : solver_(solver), line_bytes_(line_bytes), table_loops_(0) {}
+    
+    // Fill all score arrays of the batch
+    void score(CandidateBatch& batch);
+    
+    // Individual kernels (score() runs all three)
+    void score_coalescing(CandidateBatch& batch);
+    void score_strides(CandidateBatch& batch);
+    void score_conflicts(CandidateBatch& batch);
+
+private:
+    PlutoConstraintSolver& solver_;
+    int64_t line_bytes_;
+    
+    // Per-column tables (columns laid out by compute_columns)
+    size_t table_loops_;
+    std::vector<double> coalescing_table_;
+    std::vector<uint8_t> coalesced_table_;
+    std::vector<float> lines_table_;
+    std::vector<int32_t> columns_;    // Column of every candidate
+    
+    void build_tables(const CandidateBatch& batch);
+    ScheduleConfig column_config(const CandidateBatch& batch, size_t column) const;
+};
+
+} // namespace pluto_tiramisu
+
+#endif // CANDIDATE_BATCH_H
@@ -0,0 +1,296 @@
+#include "incremental_ilp.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include <gmp.h>
+extern "C" {
+#include "pluto/pluto.h"
+#include "pluto/matrix.h"
+#include "math_support.h"
+#include "constraints.h"
+#include "program.h"
+
+#ifdef GLPK
+// Defined in constraints.c but not declared in any PLUTO header
+void set_glpk_constraints_from_pluto_constraints(glp_prob* lp,
+                                                 const PlutoConstraints* cst);
+#endif
+}
+
+namespace pluto_tiramisu {
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// ============================================================================
+// Base System
+// ============================================================================
+
+IncrementalScheduleILP::IncrementalScheduleILP(PlutoProg* prog)
+    : prog_(prog), base_(nullptr), lp_(nullptr), base_rows_(0), has_basis_(false) {
+    
+    if (!prog_ || prog_->nstmts == 0) return;
+    
+    // per_cc_obj adds per-component u/w columns; the layout here assumes not
+    if (prog_->context->options->per_cc_obj) return;
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    int nvar = prog_->nvar;
+    int nstmts = prog_->nstmts;
+    
+    // The non-trivial-solution rows are skipped for statements whose trans
+    // already has enough hyperplanes; hide the current trans while building
+    std::vector<int> trans_rows(nstmts);
+    for (int i = 0; i < nstmts; i++) {
+        trans_rows[i] = prog_->stmts[i]->trans->nrows;
+        prog_->stmts[i]->trans->nrows = 0;
+    }
+    
+    // Farkas constraints per dependence (cached in dep->cst) aggregated into
+    // prog->globcst, which prog owns
+    base_ = pluto_constraints_dup(get_permutability_constraints(prog_));
+    
+    PlutoConstraints* nzcst = get_non_trivial_sol_constraints(prog_, EAGER);
+    pluto_constraints_add(base_, nzcst);
+    pluto_constraints_free(nzcst);
+    
+    for (int i = 0; i < nstmts; i++) {
+        prog_->stmts[i]->trans->nrows = trans_rows[i];
+    }
+    
+    // Coefficients of iterators that are not original loops stay 0,
+    // as in pluto_prog_constraints_lexmin
+    redundant_.assign(num_cols(), false);
+    for (int i = 0; i < nstmts; i++) {
+        for (int j = 0; j < nvar; j++) {
+            if (!prog_->stmts[i]->is_orig_loop[j]) {
+                redundant_[coeff_col(i, j)] = true;
+            }
+        }
+    }
+
+#ifdef GLPK
+    glp_prob* lp = glp_create_prob();
+    glp_set_obj_dir(lp, GLP_MIN);
+    set_glpk_constraints_from_pluto_constraints(lp, base_);
+    for (int c = 0; c < num_cols(); c++) {
+        glp_set_col_kind(lp, c + 1, GLP_IV);
+    }
+    lp_ = lp;
+    base_rows_ = base_->nrows;
+#endif
+
+    stats_.base_build_ms = elapsed_ms(start);
+}
+
+IncrementalScheduleILP::~IncrementalScheduleILP() {
+#ifdef GLPK
+    if (lp_) glp_delete_prob(static_cast<glp_prob*>(lp_));
+#endif
+    if (base_) pluto_constraints_free(base_);
+}
+
+int IncrementalScheduleILP::num_cols() const {
+    int npar = prog_->npar;
+    int nvar = prog_->nvar;
+    int nstmts = prog_->nstmts;
+    return CST_WIDTH - 1;
+}
+
+int IncrementalScheduleILP::coeff_col(int stmt, int j) const {
+    return prog_->npar + 1 + stmt * (prog_->nvar + 1) + j;
+}
+
+std::vector<double> IncrementalScheduleILP::default_objective() const {
+    // Same weights as construct_cplex_objective, spread over the full layout:
+    // bounding u heaviest, then w, then outer loop coefficients before inner
+    int npar = prog_->npar;
+    int nvar = prog_->nvar;
+    int nstmts = prog_->nstmts;
+    
+    std::vector<double> obj(num_cols(), 0.0);
+    for (int j = 0; j < npar; j++) {
+        obj[j] = 5.0 * 5 * nvar * nstmts;
+    }
+    obj[npar] = 5.0 * nvar * nstmts;
+    
+    for (int i = 0; i < nstmts; i++) {
+        Stmt* stmt = prog_->stmts[i];
+        int pos = 0;
+        for (int j = 0; j < nvar; j++) {
+            if (!stmt->is_orig_loop[j]) continue;
+            obj[coeff_col(i, j)] = (nvar + 2) * (stmt->dim_orig - pos);
+            pos++;
+        }
+        obj[coeff_col(i, nvar)] = 1.0;
+    }
+    return obj;
+}
+
+// ============================================================================
+// Per-Variant Solve
+// ============================================================================
+
+bool IncrementalScheduleILP::solve(const Variant& variant, std::vector<int64_t>& sol) {
+    sol.clear();
+    if (!base_) return false;
+    if (!variant.objective.empty() && (int)variant.objective.size() != num_cols()) {
+        return false;
+    }
+    if (variant.extra && (int)variant.extra->ncols != num_cols() + 1) {
+        return false;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    bool ok = lp_ ? solve_glpk(variant, sol) : solve_isl(variant, sol);
+    
+    stats_.num_solves++;
+    stats_.last_solve_ms = elapsed_ms(start);
+    stats_.total_solve_ms += stats_.last_solve_ms;
+    return ok;
+}
+
+bool IncrementalScheduleILP::solve_glpk(const Variant& variant, std::vector<int64_t>& sol) {
+#ifdef GLPK
+    glp_prob* lp = static_cast<glp_prob*>(lp_);
+    int ncols = num_cols();
+    int trans_offset = prog_->npar + 1;
+    
+    // Default bound when unbounded, as in get_coeff_bounding_constraints
+    int ub = variant.coeff_bound;
+    if (ub <= 0) {
+        ub = pluto_prog_get_largest_const_in_domains(prog_);
+        if (ub < 10) ub = 0;
+    }
+    
+    // Delta 1: objective and column bounds (bound changes keep the basis)
+    std::vector<double> obj = variant.objective.empty() ? default_objective()
+                                                        : variant.objective;
+    for (int c = 0; c < ncols; c++) {
+        glp_set_obj_coef(lp, c + 1, obj[c]);
+        if (redundant_[c]) {
+            glp_set_col_bnds(lp, c + 1, GLP_FX, 0.0, 0.0);
+        } else if (c >= trans_offset && ub > 0) {
+            glp_set_col_bnds(lp, c + 1, GLP_DB, 0.0, (double)ub);
+        } else {
+            glp_set_col_bnds(lp, c + 1, GLP_LO, 0.0, 0.0);
+        }
+    }
+    
+    // Delta 2: extra rows. New rows enter the basis, so the previous optimal
+    // basis stays valid and simplex resumes from it.
+    int nextra = variant.extra ? variant.extra->nrows : 0;
+    if (nextra > 0) {
+        const PlutoConstraints* extra = variant.extra;
+        int first = glp_add_rows(lp, nextra);
+        std::vector<int> ind(ncols + 1);
+        std::vector<double> val(ncols + 1);
+        for (int r = 0; r < nextra; r++) {
+            int len = 0;
+            for (int c = 0; c < ncols; c++) {
+                if (extra->val[r][c] != 0) {
+                    len++;
+                    ind[len] = c + 1;
+                    val[len] = (double)extra->val[r][c];
+                }
+            }
+            glp_set_mat_row(lp, first + r, len, ind.data(), val.data());
+            double rhs = -(double)extra->val[r][ncols];
+            glp_set_row_bnds(lp, first + r, extra->is_eq[r] ? GLP_FX : GLP_LO, rhs, 0.0);
+        }
+    }
+    
+    glp_smcp smcp;
+    glp_init_smcp(&smcp);
+    smcp.msg_lev = GLP_MSG_OFF;
+    smcp.presolve = GLP_OFF;    // presolve would discard the basis
+    
+    bool warm = has_basis_;
+    if (!warm) {
+        glp_adv_basis(lp, 0);
+    }
+    
+    int ret = glp_simplex(lp, &smcp);
+    if (ret == GLP_EBADB || ret == GLP_ESING || ret == GLP_ECOND) {
+        // Basis invalidated by the previous delta; restart from scratch
+        warm = false;
+        glp_adv_basis(lp, 0);
+        ret = glp_simplex(lp, &smcp);
+    }
+    if (warm && ret == 0) {
+        stats_.num_warm_starts++;
+    }
+    
+    bool ok = false;
+    if (ret == 0 && glp_get_status(lp) == GLP_OPT) {
+        glp_iocp iocp;
+        glp_init_iocp(&iocp);
+        iocp.msg_lev = GLP_MSG_OFF;
+        iocp.presolve = GLP_OFF;
+        
+        if (glp_intopt(lp, &iocp) == 0) {
+            int status = glp_mip_status(lp);
+            if (status == GLP_OPT || status == GLP_FEAS) {
+                sol.resize(ncols);
+                for (int c = 0; c < ncols; c++) {
+                    sol[c] = (int64_t)std::llround(glp_mip_col_val(lp, c + 1));
+                }
+                ok = true;
+            }
+        }
+    }
+    
+    // Keep the LP relaxation basis for the next variant, drop the delta rows
+    has_basis_ = (ret == 0);
+    if (nextra > 0) {
+        std::vector<int> rows(nextra + 1);
+        for (int r = 0; r < nextra; r++) rows[r + 1] = base_rows_ + r + 1;
+        glp_del_rows(lp, nextra, rows.data());
+        if (glp_warm_up(lp) != 0) has_basis_ = false;
+    }
+    return ok;
+#else
+    (void)variant;
+    (void)sol;
+    return false;
+#endif
+}
+
+bool IncrementalScheduleILP::solve_isl(const Variant& variant, std::vector<int64_t>& sol) {
+    // isl lexmin: minimizes columns lexicographically (u, w, coefficients), so
+    // objective weights do not apply; the cached base is still not rebuilt
+    int ncols = num_cols();
+    int trans_offset = prog_->npar + 1;
+    
+    PlutoConstraints* cst = pluto_constraints_dup(base_);
+    if (variant.extra) {
+        pluto_constraints_add(cst, variant.extra);
+    }
+    
+    int ub = variant.coeff_bound;
+    if (ub <= 0) {
+        ub = pluto_prog_get_largest_const_in_domains(prog_);
+        if (ub < 10) ub = 0;
+    }
+    for (int c = trans_offset; c < ncols; c++) {
+        if (redundant_[c]) {
+            pluto_constraints_add_ub(cst, c, 0);
+        } else if (ub > 0) {
+            pluto_constraints_add_ub(cst, c, ub);
+        }
+    }
+    
+    int64_t* result = pluto_constraints_lexmin_isl(cst, DO_NOT_ALLOW_NEGATIVE_COEFF);
+    pluto_constraints_free(cst);
+    if (!result) return false;
+    
+    sol.assign(result, result + ncols);
+    free(result);
+    return true;
+}
+
+} // namespace pluto_tiramisu
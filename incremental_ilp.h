@@ -0,0 +1,100 @@
+#ifndef INCREMENTAL_ILP_H
+#define INCREMENTAL_ILP_H
+
+#include <cstdint>
+#include <vector>
+
+// Forward declarations (PLUTO C types)
+struct plutoProg;
+typedef struct plutoProg PlutoProg;
+struct pluto_constraints;
+typedef struct pluto_constraints PlutoConstraints;
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// Incremental Schedule ILP - Reuse the Farkas system across PLUTO variants
+// ============================================================================
+//
+// pluto_auto_transform rebuilds the dependence constraints (Farkas lemma per
+// dependence, then get_permutability_constraints) on every solve, and
+// pluto_prog_constraints_lexmin_glpk creates a fresh glp_prob each time.
+// When many variants of the same program are solved (objective weights,
+// coefficient bounds, fusion choices), that construction dominates.
+//
+// This solver builds the base system for the outermost hyperplane once.
+// A variant only contributes its delta: objective weights, column bounds and
+// extra rows. With GLPK the problem object is kept alive, so each variant's
+// simplex starts from the previous optimal basis. Without GLPK the cached
+// system is handed to isl lexmin (no warm start, but no rebuild either).
+
+class IncrementalScheduleILP {
+public:
+    // Per-variant delta on top of the cached base system
+    struct Variant {
+        // Objective weight per column (size = num_cols()); empty means
+        // PLUTO's default weights (construct_cplex_objective)
+        std::vector<double> objective;
+        
+        // Upper bound on the transformation coefficients (<= 0: PLUTO's
+        // default from get_coeff_bounding_constraints)
+        int coeff_bound;
+        
+        // Extra rows in the same column layout; not owned
+        const PlutoConstraints* extra;
+        
+        Variant() : coeff_bound(0), extra(nullptr) {}
+    };
+    
+    struct Stats {
+        int num_solves;
+        int num_warm_starts;
+        double base_build_ms;
+        double last_solve_ms;
+        double total_solve_ms;
+        
+        Stats() : num_solves(0), num_warm_starts(0), base_build_ms(0.0),
+                  last_solve_ms(0.0), total_solve_ms(0.0) {}
+    };
+    
+    // Builds the base system from prog's dependences; prog must outlive this
+    explicit IncrementalScheduleILP(PlutoProg* prog);
+    ~IncrementalScheduleILP();
+    
+    IncrementalScheduleILP(const IncrementalScheduleILP&) = delete;
+    IncrementalScheduleILP& operator=(const IncrementalScheduleILP&) = delete;
+    
+    bool is_valid() const { return base_ != nullptr; }
+    
+    // Columns: [u (npar), w, per stmt: nvar coefficients + constant]
+    int num_cols() const;
+    
+    // Column of coefficient j of statement stmt (j == nvar: constant shift)
+    int coeff_col(int stmt, int j) const;
+    
+    // PLUTO's default objective in this column layout
+    std::vector<double> default_objective() const;
+    
+    // Solve one variant; sol receives num_cols() values. False if infeasible.
+    bool solve(const Variant& variant, std::vector<int64_t>& sol);
+    
+    const Stats& stats() const { return stats_; }
+
+private:
+    PlutoProg* prog_;
+    PlutoConstraints* base_;
+    std::vector<bool> redundant_;   // Columns PLUTO always sets to 0
+    Stats stats_;
+    
+    // GLPK problem kept across solves (glp_prob*; void* keeps glpk.h private)
+    void* lp_;
+    int base_rows_;
+    bool has_basis_;
+    
+    bool solve_glpk(const Variant& variant, std::vector<int64_t>& sol);
+    bool solve_isl(const Variant& variant, std::vector<int64_t>& sol);
+};
+
+} // namespace pluto_tiramisu
+
+#endif // INCREMENTAL_ILP_H
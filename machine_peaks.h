@@ -0,0 +1,26 @@
+#ifndef MACHINE_PEAKS_H
+#define MACHINE_PEAKS_H
+
+#include <cstdint>
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// Machine Peak Probes - Micro-benchmarks behind MachinePeaks::measure
+// ============================================================================
+//
+// This file is compiled on its own with -O3 -march=native (CMakeLists.txt):
+// built like the rest of the library, without optimization, the compute
+// probe keeps its accumulators in memory and times loads and stores instead
+// of the FMA units. The probes instantiate no templates, so no -march=native
+// copy of an inline function shared with other objects ends up in the link.
+
+// Double-precision multiply-add throughput of one core, in GFLOP/s
+double probe_peak_gflops();
+
+// Read bandwidth of one core over a working set of the given size, in GB/s
+double probe_read_bandwidth_gbs(int64_t bytes);
+
+} // namespace pluto_tiramisu
+
+#endif // MACHINE_PEAKS_H
@@ -1,11 +1,39 @@
 #include "pluto_guided_search.h"
+#include "tuning_database.h"
+#include "surrogate_model.h"
+#include "bridge_profiler.h"
+#include "candidate_batch.h"
+#include "machine_peaks.h"
+#include "incremental_ilp.h"
 #include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <atomic>
+#include <random>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
+// math_support.h pulls in gmp.h, whose C++ overloads must stay outside extern "C"
+#include <gmp.h>
 extern "C" {
 #include "pluto/pluto.h"
+#include "math_support.h"
+#include "constraints.h"
+#include "program.h"
+#include "tile_size_selection_model.h"
 }
 
 namespace pluto_tiramisu {
@@ -18,33 +46,91 @@ std::vector<ScheduleConfig> PlutoConstraintSolver::generate_candidates_from_opti
     PlutoProg* optimal_prog,
     int num_candidates
 ) {
+    ScopedPhase phase(PHASE_CANDIDATE_GENERATION);
     std::vector<ScheduleConfig> candidates;
     
+    if (access_patterns_.empty()) {
+        access_patterns_ = derive_access_patterns(optimal_prog);
+    }
+    
     // 1. Add PLUTO optimal as baseline
     ScheduleConfig optimal_config = pluto_prog_to_config(optimal_prog);
+    std::vector<Transformation> parallel = parallel_transformations(optimal_prog);
+    optimal_config.transformations.insert(optimal_config.transformations.end(),
+                                          parallel.begin(), parallel.end());
     optimal_config.description = "PLUTO Optimal";
     candidates.push_back(optimal_config);
     
-    // 2. Generate tiling size variants
-    std::vector<int> tile_variants = {16, 32, 64, 128, 256};
+    // 2. Generate tiling size variants around PLUTO's tile size model
     int ndims = optimal_prog->nvar;
+    std::vector<std::vector<ScheduleConfig::TileSize>> tile_variants;
     
-    for (int base_tile : tile_variants) {
-        if (candidates.size() >= (size_t)num_candidates) break;
+    std::vector<ScheduleConfig::TileSize> seed = model_tile_sizes(optimal_prog);
+    if (!seed.empty()) {
+        tile_variants = tile_size_neighbourhood(seed, num_candidates);
+    } else {
+        // Model not applicable: uniform sizes on every dimension
+        for (int base_tile : {16, 32, 64, 128, 256}) {
+            std::vector<ScheduleConfig::TileSize> uniform;
+            for (int d = 0; d < ndims; d++) {
+                ScheduleConfig::TileSize ts;
+                ts.loop_name = optimal_prog->stmts[0]->iterators[d];
+                ts.size = base_tile;
+                uniform.push_back(ts);
+            }
+            tile_variants.push_back(uniform);
+        }
+    }
+    
+    // Two- and three-level variants of the model's tile: L2 (and L3)
+    // tiles around it, lowered as nested tiles
+    std::vector<ScheduleConfig> hierarchy;
+    if (!tile_variants.empty()) {
+        const std::vector<ScheduleConfig::TileSize>& inner = tile_variants[0];
+        std::vector<std::vector<ScheduleConfig::TileSize>> outer = hierarchy_tile_levels(inner);
+        for (size_t k = 1; k <= outer.size(); k++) {
+            ScheduleConfig variant = optimal_config;
+            variant.tile_sizes = inner;
+            variant.outer_tile_sizes.assign(outer.end() - k, outer.end());
+            
+            // Outer tiles count against the cores at the outermost level
+            variant.transformations.erase(
+                std::remove_if(variant.transformations.begin(), variant.transformations.end(),
+                               [](const Transformation& t) { return t.type == TRANS_PARALLELIZE; }),
+                variant.transformations.end());
+            std::vector<Transformation> outer_parallel =
+                parallel_transformations(optimal_prog, variant.outer_tile_sizes.front());
+            variant.transformations.insert(variant.transformations.end(),
+                                           outer_parallel.begin(), outer_parallel.end());
+            
+            variant.description = std::to_string(k + 1) + "-level tiling";
+            for (size_t d = 0; d < inner.size(); d++) {
+                variant.description += " " + inner[d].loop_name + "=";
+                for (const auto& level : variant.outer_tile_sizes) {
+                    variant.description += std::to_string(level[d].size) + "/";
+                }
+                variant.description += std::to_string(inner[d].size);
+            }
+            
+            check_bank_conflict(variant, variant.bank_conflict_way);
+            variant.has_bank_conflict = (variant.bank_conflict_way > 1);
+            if (satisfies_coalescing_constraint(variant)) {
+                hierarchy.push_back(variant);
+            }
+        }
+    }
+    
+    for (const auto& sizes : tile_variants) {
+        if (candidates.size() + hierarchy.size() >= (size_t)num_candidates) break;
         
         ScheduleConfig variant = optimal_config;
-        variant.tile_sizes.clear();
+        variant.tile_sizes = sizes;
         
-        // Set tile size for each dimension
-        for (int d = 0; d < ndims; d++) {
-            ScheduleConfig::TileSize ts;
-            ts.loop_name = optimal_prog->stmts[0]->iterators[d];
-            ts.size = base_tile;
-            variant.tile_sizes.push_back(ts);
+        variant.description = "Tiling variant";
+        for (const auto& ts : sizes) {
+            variant.description += " " + ts.loop_name + "=" + std::to_string(ts.size);
         }
         
-        variant.description = "Tiling variant " + std::to_string(base_tile);
-        
         // Check and mark constraints
         variant.has_coalescing_violation = !satisfies_coalescing_constraint(variant);
         check_bank_conflict(variant, variant.bank_conflict_way);
@@ -55,6 +141,11 @@ std::vector<ScheduleConfig> PlutoConstraintSolver::generate_candidates_from_opti
         }
     }
     
+    for (const auto& variant : hierarchy) {
+        if (candidates.size() >= (size_t)num_candidates) break;
+        candidates.push_back(variant);
+    }
+    
     // 3. Generateloops （preservecoalescing）
     if (ndims >= 2 && candidates.size() < (size_t)num_candidates) {
         // Swap outerloops（preserveinnermostunchanged to maintaincoalescing）
@@ -62,109 +153,554 @@ std::vector<ScheduleConfig> PlutoConstraintSolver::generate_candidates_from_opti
         // loopsorder variantsrequires Implementation
     }
     
-    std::cout << "Y Generated " << candidates.size() 
-              << " candidates from PLUTO optimal\n\n";
-    
-    // Each 
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-    std::cout << "Generated Configurations:\n";
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    BridgeProfiler::instance().count("candidates_generated", candidates.size());
+    bridge_log() << "Y Generated " << candidates.size() 
+                 << " candidates from PLUTO optimal\n\n";
     
-    for (size_t i = 0; i < candidates.size(); i++) {
-        std::cout << "Config " << (i+1) << ": " << candidates[i].description << "\n";
-        
-        if (!candidates[i].transformations.empty()) {
-            std::cout << "  Transformations: " << candidates[i].transformations.size() << "\n";
-            for (size_t j = 0; j < candidates[i].transformations.size(); j++) {
-                std::cout << "    [" << j << "] Type: ";
-                switch (candidates[i].transformations[j].type) {
-                    case TRANS_TILE: std::cout << "TILE"; break;
-                    case TRANS_GPU_TILE: std::cout << "GPU_TILE"; break;
-                    case TRANS_INTERCHANGE: std::cout << "INTERCHANGE"; break;
-                    case TRANS_SKEW: std::cout << "SKEW"; break;
-                    case TRANS_PARALLELIZE: std::cout << "PARALLELIZE"; break;
-                    case TRANS_SPLIT: std::cout << "SPLIT"; break;
-                }
-                
-                if (!candidates[i].transformations[j].iterator_names.empty()) {
-                    std::cout << ", Iterators: ";
-                    for (const auto& name : candidates[i].transformations[j].iterator_names) {
-                        std::cout << name << " ";
+    if (BridgeProfiler::instance().verbose()) {
+        // Each 
+        bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        bridge_log() << "Generated Configurations:\n";
+        bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+        
+        for (size_t i = 0; i < candidates.size(); i++) {
+            bridge_log() << "Config " << (i+1) << ": " << candidates[i].description << "\n";
+            
+            if (!candidates[i].transformations.empty()) {
+                bridge_log() << "  Transformations: " << candidates[i].transformations.size() << "\n";
+                for (size_t j = 0; j < candidates[i].transformations.size(); j++) {
+                    bridge_log() << "    [" << j << "] Type: ";
+                    switch (candidates[i].transformations[j].type) {
+                        case TRANS_TILE: bridge_log() << "TILE"; break;
+                        case TRANS_GPU_TILE: bridge_log() << "GPU_TILE"; break;
+                        case TRANS_INTERCHANGE: bridge_log() << "INTERCHANGE"; break;
+                        case TRANS_SKEW: bridge_log() << "SKEW"; break;
+                        case TRANS_PARALLELIZE: bridge_log() << "PARALLELIZE"; break;
+                        case TRANS_SPLIT: bridge_log() << "SPLIT"; break;
+                        case TRANS_VECTORIZE: bridge_log() << "VECTORIZE"; break;
+                        case TRANS_UNROLL: bridge_log() << "UNROLL"; break;
+                        case TRANS_REVERSE: bridge_log() << "REVERSE"; break;
+                        case TRANS_DIAMOND_TILE: bridge_log() << "DIAMOND_TILE"; break;
+                        case TRANS_UNROLL_JAM: bridge_log() << "UNROLL_JAM"; break;
+                    }
+                    
+                    if (!candidates[i].transformations[j].iterator_names.empty()) {
+                        bridge_log() << ", Iterators: ";
+                        for (const auto& name : candidates[i].transformations[j].iterator_names) {
+                            bridge_log() << name << " ";
+                        }
                     }
+                    bridge_log() << "\n";
                 }
-                std::cout << "\n";
             }
-        }
-        
-        if (!candidates[i].tile_sizes.empty()) {
-            std::cout << "  Tile Sizes:\n";
-            for (const auto& ts : candidates[i].tile_sizes) {
-                std::cout << "    " << ts.loop_name << ": " << ts.size << "\n";
+            
+            if (!candidates[i].tile_sizes.empty()) {
+                bridge_log() << "  Tile Sizes:\n";
+                for (const auto& ts : candidates[i].tile_sizes) {
+                    bridge_log() << "    " << ts.loop_name << ": " << ts.size << "\n";
+                }
             }
+            
+            bridge_log() << "  Coalescing: " 
+                         << (satisfies_coalescing_constraint(candidates[i]) ? "Y" : "N") << "\n";
+            bridge_log() << "  Legal: " 
+                         << (is_legal_config(candidates[i]) ? "Y" : "N") << "\n";
+            bridge_log() << "\n";
         }
-        
-        std::cout << "  Coalescing: " 
-                  << (satisfies_coalescing_constraint(candidates[i]) ? "Y" : "N") << "\n";
-        std::cout << "  Legal: " 
-                  << (is_legal_config(candidates[i]) ? "Y" : "N") << "\n";
-        std::cout << "\n";
     }
     
     return candidates;
 }
 
-std::vector<ScheduleConfig> PlutoConstraintSolver::generate_all_legal_configs(
-    int num_loops,
+LegalConfigEnumerator PlutoConstraintSolver::enumerate_legal_configs(
+    PlutoProg* prog,
     const std::vector<std::string>& loop_names,
+    const std::vector<int>& tile_options,
     bool only_coalesced
 ) {
+    return LegalConfigEnumerator(this, prog, loop_names, tile_options, only_coalesced);
+}
+
+std::vector<ScheduleConfig> PlutoConstraintSolver::generate_all_legal_configs(
+    PlutoProg* prog,
+    const std::vector<std::string>& loop_names,
+    bool only_coalesced,
+    size_t max_configs
+) {
+    ScopedPhase phase(PHASE_CANDIDATE_GENERATION);
     std::vector<ScheduleConfig> candidates;
     
-    // simplifiedImplementation：Generate
-    for (int i = 0; i < num_loops; i++) {
-        ScheduleConfig config;
-        config.description = "Config with loop " + std::to_string(i) + " innermost";
-        
-        if (!only_coalesced || is_legal_config(config)) {
-            candidates.push_back(config);
-        }
+    if (access_patterns_.empty()) {
+        access_patterns_ = derive_access_patterns(prog);
+    }
+    
+    LegalConfigEnumerator enumerator = enumerate_legal_configs(
+        prog, loop_names, {16, 32, 64, 128, 256}, only_coalesced);
+    
+    ScheduleConfig config;
+    while (candidates.size() < max_configs && enumerator.next(config)) {
+        candidates.push_back(config);
     }
     
-    std::cout << "Y Generated " << candidates.size() 
-              << " legal configs\n\n";
+    BridgeProfiler::instance().count("candidates_generated", candidates.size());
+    bridge_log() << "Y Generated " << candidates.size() 
+                 << " legal configs (" << enumerator.num_permutations()
+                 << " legal loop orders visited, "
+                 << enumerator.num_pruned_prefixes() << " illegal prefixes pruned)\n\n";
     
     // Print config details
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-    std::cout << "All Legal Configurations:\n";
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    bridge_log() << "All Legal Configurations:\n";
+    bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
     
     for (size_t i = 0; i < candidates.size(); i++) {
-        std::cout << "Config " << (i+1) << ": " << candidates[i].description << "\n";
-        std::cout << "  Status: Legal Y\n\n";
+        bridge_log() << "Config " << (i+1) << ": " << candidates[i].description << "\n";
+        bridge_log() << "  Status: Legal Y\n\n";
     }
     
     return candidates;
 }
 
+// ----------------------------------------------------------------------------
+// Perturbed PLUTO solves
+// ----------------------------------------------------------------------------
+
+static void set_constraints_context(PlutoConstraints* cst, PlutoContext* ctx) {
+    for (; cst; cst = cst->next) cst->context = ctx;
+}
+
+static void swap_constraint_cols(PlutoConstraints* cst, int c1, int c2) {
+    if (cst) pluto_constraints_interchange_cols(cst, c1, c2);
+}
+
+// Deep copy of a program bound to another PlutoContext, so it can be
+// transformed on another thread
+static PlutoProg* copy_prog_to_context(const PlutoProg* src, PlutoContext* ctx) {
+    PlutoProg* prog = pluto_prog_alloc(ctx);
+    
+    pluto_constraints_free(prog->param_context);
+    pluto_constraints_free(prog->codegen_context);
+    prog->param_context = pluto_constraints_dup(src->param_context);
+    prog->codegen_context = pluto_constraints_dup(src->codegen_context);
+    set_constraints_context(prog->param_context, ctx);
+    set_constraints_context(prog->codegen_context, ctx);
+    
+    prog->npar = src->npar;
+    prog->params = (char**)malloc(std::max(1, src->npar) * sizeof(char*));
+    for (int i = 0; i < src->npar; i++) {
+        prog->params[i] = strdup(src->params[i]);
+    }
+    prog->nvar = src->nvar;
+    strcpy(prog->decls, src->decls);
+    
+    prog->num_data = src->num_data;
+    if (src->num_data > 0) {
+        prog->data_names = (char**)malloc(src->num_data * sizeof(char*));
+        for (int i = 0; i < src->num_data; i++) {
+            prog->data_names[i] = strdup(src->data_names[i]);
+        }
+    }
+    
+    prog->nstmts = src->nstmts;
+    prog->stmts = (Stmt**)malloc(std::max(1u, src->nstmts) * sizeof(Stmt*));
+    for (unsigned s = 0; s < src->nstmts; s++) {
+        Stmt* stmt = pluto_stmt_dup(src->stmts[s]);
+        stmt->id = src->stmts[s]->id;
+        set_constraints_context(stmt->domain, ctx);
+        stmt->trans->context = ctx;
+        for (int a = 0; a < stmt->nreads; a++) stmt->reads[a]->mat->context = ctx;
+        for (int a = 0; a < stmt->nwrites; a++) stmt->writes[a]->mat->context = ctx;
+        prog->stmts[s] = stmt;
+    }
+    
+    auto copy_deps = [&](Dep** deps, int ndeps) {
+        Dep** copies = (Dep**)malloc(std::max(1, ndeps) * sizeof(Dep*));
+        for (int d = 0; d < ndeps; d++) {
+            Dep* dep = pluto_dep_dup(deps[d]);
+            set_constraints_context(dep->dpolytope, ctx);
+            set_constraints_context(dep->bounding_poly, ctx);
+            set_constraints_context(dep->src_unique_dpolytope, ctx);
+            set_constraints_context(dep->depsat_poly, ctx);
+            set_constraints_context(dep->cst, ctx);
+            set_constraints_context(dep->bounding_cst, ctx);
+            copies[d] = dep;
+        }
+        return copies;
+    };
+    prog->ndeps = src->ndeps;
+    prog->deps = copy_deps(src->deps, src->ndeps);
+    prog->ntransdeps = src->ntransdeps;
+    prog->transdeps = copy_deps(src->transdeps, src->ntransdeps);
+    
+    return prog;
+}
+
+// Swap iterators c1 and c2 of a statement everywhere they appear. The
+// lexmin objective prefers earlier columns on ties, so this changes which
+// of several equally good hyperplanes PLUTO picks.
+static void swap_stmt_iterators(PlutoProg* prog, Stmt* stmt, int c1, int c2) {
+    swap_constraint_cols(stmt->domain, c1, c2);
+    pluto_matrix_interchange_cols(stmt->trans, c1, c2);
+    for (int a = 0; a < stmt->nreads; a++) {
+        pluto_matrix_interchange_cols(stmt->reads[a]->mat, c1, c2);
+    }
+    for (int a = 0; a < stmt->nwrites; a++) {
+        pluto_matrix_interchange_cols(stmt->writes[a]->mat, c1, c2);
+    }
+    std::swap(stmt->iterators[c1], stmt->iterators[c2]);
+    std::swap(stmt->is_orig_loop[c1], stmt->is_orig_loop[c2]);
+    
+    // Dependence polyhedra: [src iterators, dest iterators, params, 1]
+    auto swap_dep = [&](Dep* dep) {
+        int offsets[2] = {-1, -1};
+        if (dep->src == stmt->id) offsets[0] = 0;
+        if (dep->dest == stmt->id) offsets[1] = prog->stmts[dep->src]->dim;
+        for (int off : offsets) {
+            if (off < 0) continue;
+            swap_constraint_cols(dep->dpolytope, off + c1, off + c2);
+            swap_constraint_cols(dep->bounding_poly, off + c1, off + c2);
+            swap_constraint_cols(dep->src_unique_dpolytope, off + c1, off + c2);
+            swap_constraint_cols(dep->depsat_poly, off + c1, off + c2);
+        }
+        // Farkas constraints are recomputed from the permuted polyhedra
+        if (offsets[0] >= 0 || offsets[1] >= 0) {
+            if (dep->cst) pluto_constraints_free(dep->cst);
+            if (dep->bounding_cst) pluto_constraints_free(dep->bounding_cst);
+            dep->cst = NULL;
+            dep->bounding_cst = NULL;
+        }
+    };
+    for (int d = 0; d < prog->ndeps; d++) swap_dep(prog->deps[d]);
+    for (int d = 0; d < prog->ntransdeps; d++) swap_dep(prog->transdeps[d]);
+}
+
+std::vector<ScheduleConfig> PlutoConstraintSolver::solve_perturbed_programs(
+    PlutoProg* base_prog,
+    int num_solves
+) {
+    std::vector<ScheduleConfig> configs;
+    if (!base_prog || num_solves <= 0 || base_prog->nstmts == 0) return configs;
+    
+    // Perturbation k: iterator priority rotated by k, coefficient bound and
+    // fusion heuristic cycled with co-prime periods
+    const int coeff_bounds[] = {1, -1, 2, 4};
+    const FusionType fusions[] = {options_->fuse, kNoFuse, kMaximalFuse};
+    
+    // Screen out exact duplicates: the full solve only sees the rotation of
+    // each statement's iterators (modulo its depth), the coefficient bound
+    // and the fusion heuristic, so perturbations that agree on all three
+    // yield the same schedule. Anything else may differ and gets its own
+    // pluto_auto_transform.
+    std::vector<int> distinct;
+    {
+        std::set<std::vector<int>> seen;
+        for (int k = 0; k < num_solves; k++) {
+            std::vector<int> key;
+            for (unsigned s = 0; s < base_prog->nstmts; s++) {
+                int dim = (int)base_prog->stmts[s]->dim;
+                key.push_back(dim < 2 ? 0 : (k + 1) % dim);
+            }
+            key.push_back(coeff_bounds[k % 4]);
+            key.push_back((int)fusions[k % 3]);
+            if (seen.insert(key).second) {
+                distinct.push_back(k);
+            }
+        }
+    }
+    
+    // Order the distinct perturbations by their outermost hyperplane, solved
+    // on one cached Farkas system (rotating the iterators only changes lexmin
+    // tie-breaking, i.e. the objective weights): perturbations that open a
+    // new outermost hyperplane come first in the result, ahead of those that
+    // can only differ at inner levels. This only reorders; every distinct
+    // perturbation is still solved in full below.
+    {
+        PlutoContext* ilp_ctx = pluto_context_alloc();
+        char* ilp_out_file = ilp_ctx->options->out_file;
+        *ilp_ctx->options = *options_;
+        ilp_ctx->options->out_file = ilp_out_file;
+        ilp_ctx->options->silent = 1;
+        ilp_ctx->options->quiet = 1;
+        ilp_ctx->options->debug = 0;
+        ilp_ctx->options->moredebug = 0;
+        PlutoProg* ilp_prog = copy_prog_to_context(base_prog, ilp_ctx);
+        
+        {
+            IncrementalScheduleILP ilp(ilp_prog);
+            std::set<std::vector<int64_t>> seen;
+            std::vector<int> opening, repeating;
+            int nvar = ilp_prog->nvar;
+            
+            for (int k : distinct) {
+                if (!ilp.is_valid()) {
+                    opening.push_back(k);
+                    continue;
+                }
+                
+                IncrementalScheduleILP::Variant variant;
+                variant.coeff_bound = coeff_bounds[k % 4];
+                variant.objective = ilp.default_objective();
+                int rotation = k + 1;
+                for (unsigned i = 0; i < ilp_prog->nstmts; i++) {
+                    Stmt* stmt = ilp_prog->stmts[i];
+                    int m = stmt->dim_orig;
+                    if (stmt->dim < 2 || m < 2) continue;
+                    int pos = 0;
+                    for (int j = 0; j < nvar; j++) {
+                        if (!stmt->is_orig_loop[j]) continue;
+                        int rotated = ((pos - rotation) % m + m) % m;
+                        variant.objective[ilp.coeff_col(i, j)] = (nvar + 2) * (m - rotated);
+                        pos++;
+                    }
+                }
+                
+                std::vector<int64_t> sol;
+                if (!ilp.solve(variant, sol)) {
+                    // Infeasible outermost row: PLUTO may still cut its way out
+                    opening.push_back(k);
+                    continue;
+                }
+                std::vector<int64_t> key(sol.begin() + ilp_prog->npar + 1, sol.end());
+                key.push_back((int64_t)fusions[k % 3]);
+                (seen.insert(key).second ? opening : repeating).push_back(k);
+            }
+            
+            distinct = opening;
+            distinct.insert(distinct.end(), repeating.begin(), repeating.end());
+            
+            const IncrementalScheduleILP::Stats& stats = ilp.stats();
+            bridge_log() << "Search: " << distinct.size() << "/" << num_solves
+                         << " distinct perturbations, " << opening.size()
+                         << " with a new outermost hyperplane (" << stats.num_solves
+                         << " solves, " << stats.num_warm_starts << " warm, base "
+                         << stats.base_build_ms << " ms, solves "
+                         << stats.total_solve_ms << " ms)\n";
+        }
+        
+        pluto_prog_free(ilp_prog);
+        pluto_context_free(ilp_ctx);
+    }
+    
+    struct Solve {
+        PlutoContext* ctx;
+        PlutoProg* prog;
+        std::string label;
+        bool ok;
+    };
+    int num_distinct = (int)distinct.size();
+    std::vector<Solve> solves(num_distinct);
+    
+    for (int d = 0; d < num_distinct; d++) {
+        int k = distinct[d];
+        Solve& solve = solves[d];
+        solve.ctx = pluto_context_alloc();
+        char* out_file = solve.ctx->options->out_file;
+        *solve.ctx->options = *options_;
+        solve.ctx->options->out_file = out_file;
+        solve.ctx->options->silent = 1;
+        solve.ctx->options->quiet = 1;
+        solve.ctx->options->debug = 0;
+        solve.ctx->options->moredebug = 0;
+        solve.ctx->options->coeff_bound = coeff_bounds[k % 4];
+        solve.ctx->options->fuse = fusions[k % 3];
+        
+        solve.prog = copy_prog_to_context(base_prog, solve.ctx);
+        int rotation = k + 1;
+        for (unsigned s = 0; s < solve.prog->nstmts; s++) {
+            Stmt* stmt = solve.prog->stmts[s];
+            if (stmt->dim < 2) continue;
+            for (int r = 0; r < rotation % (int)stmt->dim; r++) {
+                for (unsigned c = 0; c + 1 < stmt->dim; c++) {
+                    swap_stmt_iterators(solve.prog, stmt, c, c + 1);
+                }
+            }
+        }
+        
+        solve.label = "rotate " + std::to_string(rotation) +
+                      ", coeff_bound " + std::to_string(coeff_bounds[k % 4]) +
+                      ", fuse " + std::to_string((int)fusions[k % 3]);
+        solve.ok = false;
+    }
+    
+    // Independent solves run concurrently: every copy has its own
+    // PlutoContext, and PLUTO allocates its own isl_ctx per ILP
+    std::atomic<int> next_solve(0);
+    auto worker = [&]() {
+        for (int d = next_solve++; d < num_distinct; d = next_solve++) {
+            Solve& solve = solves[d];
+            {
+                ScopedPhase phase(PHASE_PLUTO_SOLVE);
+                solve.ok = pluto_auto_transform(solve.prog) == 0;
+            }
+            BridgeProfiler::instance().count("pluto_solves");
+            if (solve.ok) {
+                pluto_compute_dep_directions(solve.prog);
+                pluto_compute_dep_satisfaction(solve.prog);
+            }
+        }
+    };
+    
+    int num_threads = std::max(1, std::min<int>(num_distinct,
+                                                 std::thread::hardware_concurrency()));
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    for (auto& solve : solves) {
+        if (solve.ok) {
+            ScheduleConfig config = pluto_prog_to_config(solve.prog);
+            std::vector<Transformation> parallel = parallel_transformations(solve.prog);
+            config.transformations.insert(config.transformations.end(),
+                                          parallel.begin(), parallel.end());
+            config.tile_sizes = model_tile_sizes(solve.prog);
+            config.description = "PLUTO sample (" + solve.label + ")";
+            configs.push_back(config);
+        }
+        pluto_prog_free(solve.prog);
+        pluto_context_free(solve.ctx);
+    }
+    
+    bridge_log() << "Search: " << configs.size() << "/" << num_distinct
+                 << " perturbed PLUTO solves succeeded on " << num_threads << " threads ("
+                 << std::chrono::duration<double, std::milli>(end - start).count()
+                 << " ms)\n";
+    
+    return configs;
+}
+
+std::vector<ScheduleConfig> PlutoConstraintSolver::generate_diamond_tiled(
+    PlutoProg* base_prog,
+    bool full_diamond,
+    const std::vector<int>& tile_sizes
+) {
+    std::vector<ScheduleConfig> configs;
+    if (!base_prog || base_prog->nstmts == 0 || tile_sizes.empty()) return configs;
+    
+    if (access_patterns_.empty()) {
+        access_patterns_ = derive_access_patterns(base_prog);
+    }
+    
+    PlutoContext* ctx = pluto_context_alloc();
+    char* out_file = ctx->options->out_file;
+    *ctx->options = *options_;
+    ctx->options->out_file = out_file;
+    ctx->options->silent = 1;
+    ctx->options->quiet = 1;
+    ctx->options->debug = 0;
+    ctx->options->moredebug = 0;
+    ctx->options->diamondtile = 1;
+    ctx->options->fulldiamondtile = full_diamond ? 1 : 0;
+    
+    PlutoProg* prog = copy_prog_to_context(base_prog, ctx);
+    bool ok;
+    {
+        ScopedPhase phase(PHASE_PLUTO_SOLVE);
+        ok = pluto_auto_transform(prog) == 0;
+    }
+    BridgeProfiler::instance().count("pluto_solves");
+    
+    if (ok && prog->is_diamond_tiled) {
+        // Fusion structure of PLUTO's schedule; each nest gains the tile loops
+        ScheduleConfig structure = pluto_prog_to_config(prog);
+        
+        for (int size : tile_sizes) {
+            std::vector<Transformation> tiles = diamond_tile_transformations(prog, size);
+            if (tiles.empty()) break;
+            
+            ScheduleConfig config;
+            config.transformations = tiles;
+            for (const auto& sched : structure.statements) {
+                StatementSchedule st = sched;
+                for (const auto& tile : tiles) {
+                    if (tile.statement_id == sched.statement_id) {
+                        st.loop_order = diamond_loop_names(tile);
+                    }
+                }
+                if (!config.statements.empty()) {
+                    st.fused_loops += (int)tiles[0].tile_sizes.size();
+                }
+                config.statements.push_back(st);
+            }
+            config.description = std::string("Diamond tiling (") +
+                                 (full_diamond ? "full" : "concurrent start") +
+                                 ") T=" + std::to_string(size);
+            configs.push_back(config);
+        }
+    }
+    
+    bridge_log() << "Search: " << configs.size() << " diamond-tiled config(s)"
+                 << (full_diamond ? " (full diamonds)" : "") << "\n";
+    
+    pluto_prog_free(prog);
+    pluto_context_free(ctx);
+    return configs;
+}
+
+// Loop orders and fusion structure of a config (tile sizes ignored)
+static std::string schedule_signature(const ScheduleConfig& config) {
+    std::string sig;
+    for (const auto& trans : config.transformations) {
+        sig += std::to_string((int)trans.type) + ":" + std::to_string(trans.statement_id);
+        for (const auto& name : trans.iterator_names) sig += "," + name;
+        for (int c : trans.coefficients) sig += "*" + std::to_string(c);
+        for (const auto& row : trans.hyperplanes) {
+            sig += "/";
+            for (int64_t c : row) sig += " " + std::to_string(c);
+        }
+        sig += ";";
+    }
+    for (const auto& st : config.statements) {
+        sig += "|S" + std::to_string(st.statement_id) + "@" + std::to_string(st.fused_loops);
+        for (const auto& name : st.loop_order) sig += "," + name;
+    }
+    return sig;
+}
+
 std::vector<ScheduleConfig> PlutoConstraintSolver::generate_by_constraint_sampling(
     PlutoProg* base_prog,
     int num_samples
 ) {
+    ScopedPhase phase(PHASE_CANDIDATE_GENERATION);
     std::vector<ScheduleConfig> candidates;
     
     // Baseline config
     candidates.push_back(pluto_prog_to_config(base_prog));
     candidates.back().description = "Base PLUTO solution";
+    std::vector<Transformation> parallel = parallel_transformations(base_prog);
+    candidates.back().transformations.insert(candidates.back().transformations.end(),
+                                             parallel.begin(), parallel.end());
+    
+    // Tile sizes: neighbourhood of the tile size model's choice
+    std::vector<ScheduleConfig::TileSize> seed = model_tile_sizes(base_prog);
+    if (!seed.empty()) {
+        candidates[0].tile_sizes = seed;
+    }
+    
+    // Structurally different schedules: re-solve perturbed copies
+    std::set<std::string> structures = {schedule_signature(candidates[0])};
+    for (auto& config : solve_perturbed_programs(base_prog, num_samples - 1)) {
+        if ((int)candidates.size() >= num_samples) break;
+        if (structures.insert(schedule_signature(config)).second) {
+            candidates.push_back(config);
+        }
+    }
+    
+    // Remaining slots: tile variants of the base solution
+    std::vector<std::vector<ScheduleConfig::TileSize>> tile_variants =
+        tile_size_neighbourhood(candidates[0].tile_sizes, num_samples);
     
-    // Generatetile size 
-    std::vector<int> tile_variants = {16, 32, 64, 128};
     for (size_t i = 1; i < tile_variants.size() && (int)candidates.size() < num_samples; i++) {
         ScheduleConfig config = candidates[0];
-        config.description = "Tile variant " + std::to_string(tile_variants[i]);
-        
-        // Updatetile sizes
-        for (auto& ts : config.tile_sizes) {
-            ts.size = tile_variants[i];
+        config.tile_sizes = tile_variants[i];
+        config.description = "Tile variant";
+        for (const auto& ts : config.tile_sizes) {
+            config.description += " " + ts.loop_name + "=" + std::to_string(ts.size);
         }
         
         if (satisfies_coalescing_constraint(config)) {
@@ -172,24 +708,27 @@ std::vector<ScheduleConfig> PlutoConstraintSolver::generate_by_constraint_sampli
         }
     }
     
-    std::cout << "Y Generated " << candidates.size() 
-              << " candidates by constraint sampling\n\n";
+    BridgeProfiler::instance().count("candidates_generated", candidates.size());
+    bridge_log() << "Y Generated " << candidates.size() 
+                 << " candidates by constraint sampling\n\n";
     
-    // Print sampled configs
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-    std::cout << "Sampled Configurations:\n";
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
-    
-    for (size_t i = 0; i < candidates.size(); i++) {
-        std::cout << "Sample " << (i+1) << ": " << candidates[i].description << "\n";
+    if (BridgeProfiler::instance().verbose()) {
+        // Print sampled configs
+        bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        bridge_log() << "Sampled Configurations:\n";
+        bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
         
-        if (!candidates[i].tile_sizes.empty()) {
-            std::cout << "  Tile Configuration:\n";
-            for (const auto& ts : candidates[i].tile_sizes) {
-                std::cout << "    " << ts.loop_name << " = " << ts.size << "\n";
+        for (size_t i = 0; i < candidates.size(); i++) {
+            bridge_log() << "Sample " << (i+1) << ": " << candidates[i].description << "\n";
+            
+            if (!candidates[i].tile_sizes.empty()) {
+                bridge_log() << "  Tile Configuration:\n";
+                for (const auto& ts : candidates[i].tile_sizes) {
+                    bridge_log() << "    " << ts.loop_name << " = " << ts.size << "\n";
+                }
             }
+            bridge_log() << "\n";
         }
-        std::cout << "\n";
     }
     
     return candidates;
@@ -200,6 +739,11 @@ bool PlutoConstraintSolver::satisfies_coalescing_constraint(
 ) {
     if (config.transformations.empty()) return false;
     
+    // With known accesses: at least one array must be unit-stride
+    if (!access_patterns_.empty()) {
+        return compute_weighted_coalescing_score(config, access_patterns_) > 0;
+    }
+    
     // Simplified check: innermost should have stride=1
     // Actual PLUTO constraint: h · ∇f ≥ 1
     const auto& innermost = config.transformations.back();
@@ -212,46 +756,79 @@ bool PlutoConstraintSolver::satisfies_coalescing_constraint(
     return true;
 }
 
-// NEW: Checkshared memory bank conflict
+// NEW: Check bank / cache-set conflict with the configured analyser
 bool PlutoConstraintSolver::check_bank_conflict(
     const ScheduleConfig& config, 
     int& conflict_way
 ) {
     conflict_way = 1; // Default no conflict
     
-    // GPU shared memoryhas32banks (NVIDIA)
-    // Bank conflictat：Multibank Address
+    if (conflict_analyzer_) {
+        conflict_way = std::max(1, conflict_analyzer_->analyze(config, access_patterns_));
+    }
     
-    // Checktile sizes
-    for (const auto& ts : config.tile_sizes) {
-        // Iftile size32 ，bank conflict
-        // ：tile_x = 33 → 0 and 32 bank
-        if (ts.size % 32 != 0 && ts.size > 1) {
-            // conflict
-            int gcd = 32;
-            int remainder = ts.size % 32;
-            
-            // Simplified conflict detection:
-            // Ifremainder32 ，has conflict
-            if (remainder != 0) {
-                // conflict way
-                for (int d = 2; d <= 32; d++) {
-                    if (32 % d == 0 && remainder % d == 0) {
-                        conflict_way = std::max(conflict_way, d);
-                    }
-                }
-            }
+    return conflict_way > 1;
+}
+
+// Innermost loop of a config: last loop-order entry (single-iterator
+// interchange) or point loop of a diamond tile, otherwise the last
+// iterator of the last transformation
+static std::string innermost_loop_name(const ScheduleConfig& config) {
+    for (auto it = config.transformations.rbegin();
+         it != config.transformations.rend(); ++it) {
+        if (it->type == TRANS_INTERCHANGE && it->iterator_names.size() == 1) {
+            return it->iterator_names[0];
         }
-        
-        // Check bad tile sizes
-        if (ts.size == 33 || ts.size == 65 || ts.size == 17) {
-            conflict_way = std::max(conflict_way, 2);
+        if (it->type == TRANS_DIAMOND_TILE && it->statement_id == 0) {
+            return diamond_loop_names(*it).back();
         }
     }
-    
-    return conflict_way > 1;
+    if (!config.transformations.empty() &&
+        !config.transformations.back().iterator_names.empty()) {
+        return config.transformations.back().iterator_names.back();
+    }
+    return "";
 }
 
+// Loop order given by single-iterator interchanges of statement 0
+static std::vector<std::string> explicit_loop_order(const ScheduleConfig& config) {
+    std::vector<std::string> order;
+    for (const auto& trans : config.transformations) {
+        if (trans.type == TRANS_INTERCHANGE && trans.statement_id == 0 &&
+            trans.iterator_names.size() == 1) {
+            order.push_back(trans.iterator_names[0]);
+        }
+    }
+    return order;
+}
+
+// Diamond tiles count as explicit: the innermost point loop is named after
+// the iterator it scans, strides come from the untransformed accesses
+static bool has_explicit_loop_order(const ScheduleConfig& config) {
+    for (const auto& trans : config.transformations) {
+        if ((trans.type == TRANS_INTERCHANGE && trans.iterator_names.size() == 1) ||
+            trans.type == TRANS_DIAMOND_TILE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Row-major element strides of each array dimension (kUnknownExtent
+// outside a dimension of unknown extent)
+static std::vector<int64_t> row_major_strides(const AccessPattern& pattern, size_t ndims) {
+    std::vector<int64_t> strides(ndims, 1);
+    for (size_t r = ndims; r-- > 1; ) {
+        int64_t extent = pattern.extent(r);
+        strides[r - 1] = (strides[r] < 0 || extent < 0) ? kUnknownExtent : strides[r] * extent;
+    }
+    return strides;
+}
+
+// Stride across a dimension of unknown extent: not unit, and far enough
+// that every access touches its own cache line
+static const int64_t kUnknownStride = std::numeric_limits<int32_t>::max();
+
 // NEW: coalescing
 // Implementation formulation: max Σ w_m · (h·∇φ_m)
 // Simplified to binary: only count coalesced arrays
@@ -263,9 +840,14 @@ double PlutoConstraintSolver::compute_weighted_coalescing_score(
     
     for (const auto& pattern : patterns) {
         // : w_m = α_m · freq_m · volume_m
+        // Real footprint (elements) of the innermost row; unknown rows
+        // weigh the same
+        int64_t row = pattern.num_dims() > 0 ? pattern.extent(pattern.num_dims() - 1)
+                                             : kUnknownExtent;
+        double volume = row > 0 ? row : 1.0;
         double weight = pattern.access_frequency * 
                        pattern.element_size * 
-                       pattern.dimension_size;
+                       volume;
         
         //  (α_m = 1.5 for writes, 1.0 for reads)
         if (pattern.is_write) {
@@ -273,7 +855,7 @@ double PlutoConstraintSolver::compute_weighted_coalescing_score(
         }
         
         //  h·∇φ_m (stride)
-        int stride = compute_stride_for_pattern(config, pattern);
+        int64_t stride = compute_stride_for_pattern(config, pattern);
         
         // ：Σ w_m · indicator(stride=1)
         // stride=1contributesw_m，otherwisecontributes0
@@ -292,13 +874,16 @@ bool PlutoConstraintSolver::check_coalescing_for_pattern(
     const AccessPattern& pattern
 ) {
     if (config.transformations.empty()) return false;
+    
+    if (pattern.has_affine_access()) {
+        return compute_stride_for_pattern(config, pattern) == 1;
+    }
+    
     if (pattern.indices.empty()) return false;
     
     // innermost loop 
-    const auto& innermost = config.transformations.back();
-    if (innermost.iterator_names.empty()) return false;
-    
-    std::string inner_var = innermost.iterator_names.back();
+    std::string inner_var = innermost_loop_name(config);
+    if (inner_var.empty()) return false;
     
     // row-major，stride=1
     // ：A[i][k]，Ifinner_var == "k"，coalesced
@@ -310,23 +895,56 @@ bool PlutoConstraintSolver::check_coalescing_for_pattern(
 }
 
 // NEW: Access pattern stride
-int PlutoConstraintSolver::compute_stride_for_pattern(
+int64_t PlutoConstraintSolver::compute_stride_for_pattern(
     const ScheduleConfig& config,
     const AccessPattern& pattern
-) {
+) const {
     if (config.transformations.empty()) return 1;
-    if (pattern.indices.empty()) return 1;
     
-    const auto& innermost = config.transformations.back();
-    if (innermost.iterator_names.empty()) return 1;
+    if (pattern.has_affine_access()) {
+        std::vector<int64_t> strides = row_major_strides(pattern, pattern.coeffs.size());
+        int64_t stride = 0;
+        
+        if (!has_explicit_loop_order(config) && !pattern.transformed_coeffs.empty()) {
+            // PLUTO's own schedule: innermost non-scalar level of the
+            // transformed access function
+            int level = -1;
+            for (size_t c = 0; c < pattern.transformed_is_loop.size(); c++) {
+                if (pattern.transformed_is_loop[c]) level = c;
+            }
+            if (level < 0) return 0;
+            for (size_t r = 0; r < pattern.transformed_coeffs.size(); r++) {
+                if (pattern.transformed_coeffs[r][level] == 0) continue;
+                if (strides[r] < 0) return kUnknownStride;
+                stride += pattern.transformed_coeffs[r][level] * strides[r];
+            }
+            return std::abs(stride);
+        }
+        
+        std::string inner_var = innermost_loop_name(config);
+        auto it = std::find(pattern.iterator_names.begin(),
+                            pattern.iterator_names.end(), inner_var);
+        if (it == pattern.iterator_names.end()) return 0;  // invariant
+        size_t col = it - pattern.iterator_names.begin();
+        
+        for (size_t r = 0; r < pattern.coeffs.size(); r++) {
+            if (pattern.coeffs[r][col] == 0) continue;
+            if (strides[r] < 0) return kUnknownStride;
+            stride += pattern.coeffs[r][col] * strides[r];
+        }
+        return std::abs(stride);
+    }
+    
+    if (pattern.indices.empty()) return 1;
     
-    std::string inner_var = innermost.iterator_names.back();
+    std::string inner_var = innermost_loop_name(config);
+    if (inner_var.empty()) return 1;
     
     // inner_varat 
     for (size_t i = 0; i < pattern.indices.size(); i++) {
         if (pattern.indices[i] == inner_var) {
             // stride（row-major）
-            int stride = 1;
+            int64_t stride = 1;
             for (size_t j = i + 1; j < pattern.indices.size(); j++) {
                 stride *= pattern.dimension_size;
             }
@@ -338,73 +956,427 @@ int PlutoConstraintSolver::compute_stride_for_pattern(
     return pattern.dimension_size * pattern.dimension_size;
 }
 
-// NEW: 
-std::vector<ScheduleConfig> PlutoConstraintSolver::filter_by_constraints(
-    std::vector<ScheduleConfig> candidates
+// ============================================================================
+// Conflict Analysers
+// ============================================================================
+
+// Legacy GPU shared memory bank conflict model
+int GpuBankConflictAnalyzer::analyze(
+    const ScheduleConfig& config,
+    const std::vector<AccessPattern>& patterns
 ) {
-    std::vector<ScheduleConfig> filtered;
+    int conflict_way = 1; // Default no conflict
     
-    for (auto& config : candidates) {
-        bool should_keep = true;
-        
-        // Checkcoalescing
-        bool has_coalescing = satisfies_coalescing_constraint(config);
-        config.has_coalescing_violation = !has_coalescing;
-        
-        if (coalescing_mode_ == ConstraintMode::HARD_CONSTRAINT && !has_coalescing) {
-            should_keep = false;
+    // GPU shared memoryhas32banks (NVIDIA)
+    // Bank conflictat：Multibank Address
+    
+    // Checktile sizes
+    for (const auto& ts : config.tile_sizes) {
+        // Iftile size32 ，bank conflict
+        // ：tile_x = 33 → 0 and 32 bank
+        if (ts.size % 32 != 0 && ts.size > 1) {
+            // conflict
+            int gcd = 32;
+            int remainder = ts.size % 32;
+            
+            // Simplified conflict detection:
+            // Ifremainder32 ，has conflict
+            if (remainder != 0) {
+                // conflict way
+                for (int d = 2; d <= 32; d++) {
+                    if (32 % d == 0 && remainder % d == 0) {
+                        conflict_way = std::max(conflict_way, d);
+                    }
+                }
+            }
         }
         
-        // Checkbank conflict
+        // Check bad tile sizes
+        if (ts.size == 33 || ts.size == 65 || ts.size == 17) {
+            conflict_way = std::max(conflict_way, 2);
+        }
+    }
+    
+    return conflict_way;
+}
+
+CacheSetConflictAnalyzer::CacheSetConflictAnalyzer() : max_lines_(1 << 16) {
+    CacheLevelGeometry l1("L1", 32 * 1024, 64, 8);
+    CacheLevelGeometry l2("L2", 1024 * 1024, 64, 16);
+    
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    long size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    long line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    long assoc = sysconf(_SC_LEVEL1_DCACHE_ASSOC);
+    if (size > 0 && line > 0 && assoc > 0) {
+        l1 = CacheLevelGeometry("L1", size, line, assoc);
+    }
+    size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    line = sysconf(_SC_LEVEL2_CACHE_LINESIZE);
+    assoc = sysconf(_SC_LEVEL2_CACHE_ASSOC);
+    if (size > 0 && line > 0 && assoc > 0) {
+        l2 = CacheLevelGeometry("L2", size, line, assoc);
+    }
+#endif
+    
+    levels_.push_back(l1);
+    levels_.push_back(l2);
+}
+
+int CacheSetConflictAnalyzer::tile_conflict_way(
+    const CacheLevelGeometry& level,
+    const ScheduleConfig& config,
+    const AccessPattern& pattern
+) const {
+    size_t ndims = pattern.has_affine_access() ? pattern.coeffs.size()
+                                               : pattern.indices.size();
+    if (ndims == 0) return 1;
+    
+    // Tile extent of every array dimension: tile size of the loop that
+    // indexes it, a single index for untiled / invariant dimensions
+    std::vector<int64_t> tile_extent(ndims, 1);
+    bool tiled = false;
+    for (size_t r = 0; r < ndims; r++) {
+        std::string iter;
+        if (pattern.has_affine_access()) {
+            for (size_t c = 0; c < pattern.iterator_names.size(); c++) {
+                if (pattern.coeffs[r][c] != 0) iter = pattern.iterator_names[c];
+            }
+        } else {
+            iter = pattern.indices[r];
+        }
+        for (const auto& ts : config.tile_sizes) {
+            if (!iter.empty() && ts.loop_name == iter && ts.size > 1) {
+                tile_extent[r] = ts.size;
+                tiled = true;
+            }
+        }
+    }
+    if (!tiled) return 1;
+    
+    // Set mapping needs real row strides
+    std::vector<int64_t> strides = row_major_strides(pattern, ndims);
+    if (strides[0] < 0) return 1;
+    int64_t num_sets = level.num_sets();
+    int64_t elem = (int64_t)pattern.element_size;
+    int64_t row_bytes = tile_extent[ndims - 1] * elem;
+    
+    // Walk every tile row (all points of the outer dimensions) and count the
+    // cache lines it occupies in each set
+    std::map<int64_t, int64_t> lines_in_set;
+    int64_t max_lines = 0;
+    int64_t simulated = 0;
+    std::vector<int64_t> idx(ndims > 1 ? ndims - 1 : 0, 0);
+    
+    while (simulated < max_lines_) {
+        int64_t addr = 0;
+        for (size_t r = 0; r + 1 < ndims; r++) {
+            addr += idx[r] * strides[r] * elem;
+        }
+        for (int64_t line = addr / level.line_bytes;
+             line <= (addr + row_bytes - 1) / level.line_bytes; line++) {
+            max_lines = std::max(max_lines, ++lines_in_set[line % num_sets]);
+            simulated++;
+        }
+        
+        // Next row (odometer over outer dimensions)
+        bool carry = true;
+        for (size_t r = idx.size(); carry && r > 0; r--) {
+            if (++idx[r - 1] < tile_extent[r - 1]) {
+                carry = false;
+            } else {
+                idx[r - 1] = 0;
+            }
+        }
+        if (carry) break;
+    }
+    
+    // A footprint larger than the cache overfills every set even when spread
+    // evenly (capacity, not conflict): only the fullest set's excess over
+    // an even spread (at least the associativity) is a conflict
+    int64_t even = (simulated + num_sets - 1) / num_sets;
+    int64_t allowed = std::max(level.associativity, even);
+    if (max_lines <= allowed) return 1;
+    return (int)((max_lines + allowed - 1) / allowed);
+}
+
+int CacheSetConflictAnalyzer::analyze(
+    const ScheduleConfig& config,
+    const std::vector<AccessPattern>& patterns
+) {
+    int conflict_way = 1;
+    for (const auto& level : levels_) {
+        for (const auto& pattern : patterns) {
+            conflict_way = std::max(conflict_way, tile_conflict_way(level, config, pattern));
+        }
+    }
+    return conflict_way;
+}
+
+// NEW: Derive access patterns from PlutoAccess matrices
+std::vector<AccessPattern> PlutoConstraintSolver::derive_access_patterns(
+    PlutoProg* prog,
+    size_t element_size
+) {
+    std::vector<AccessPattern> patterns;
+    if (!prog) return patterns;
+    
+    for (unsigned s = 0; s < prog->nstmts; s++) {
+        Stmt* stmt = prog->stmts[s];
+        
+        std::vector<std::string> iterators;
+        for (unsigned d = 0; d < stmt->dim; d++) {
+            iterators.push_back(stmt->iterators && stmt->iterators[d]
+                                ? stmt->iterators[d] : "i" + std::to_string(d));
+        }
+        
+        auto add_access = [&](PlutoAccess* acc, bool is_write) {
+            if (!acc || !acc->mat || !acc->name) return;
+            
+            AccessPattern pattern;
+            pattern.array_name = acc->name;
+            pattern.element_size = element_size;
+            pattern.is_write = is_write;
+            pattern.iterator_names = iterators;
+            
+            for (unsigned r = 0; r < acc->mat->nrows; r++) {
+                std::vector<int64_t> row(acc->mat->val[r], acc->mat->val[r] + stmt->dim);
+                pattern.coeffs.push_back(row);
+                
+                // Legacy indices: the innermost iterator the subscript uses
+                std::string index;
+                for (unsigned c = 0; c < stmt->dim; c++) {
+                    if (row[c] != 0) index = iterators[c];
+                }
+                pattern.indices.push_back(index);
+            }
+            
+            // Access over PLUTO's transformed loops
+            if (stmt->trans) {
+                int* divs = nullptr;
+                PlutoMatrix* newacc = pluto_get_new_access_func(acc->mat, stmt, &divs);
+                if (newacc) {
+                    // Row r is floor(row / divs[r]); a fractional step
+                    // rounds up (it still reaches a new element every
+                    // ceil(divs[r] / c) iterations)
+                    for (unsigned r = 0; r < newacc->nrows; r++) {
+                        int64_t div = (divs && divs[r] > 1) ? divs[r] : 1;
+                        std::vector<int64_t> row;
+                        for (unsigned c = 0; c < stmt->trans->nrows; c++) {
+                            int64_t v = newacc->val[r][c];
+                            int64_t step = (std::abs(v) + div - 1) / div;
+                            row.push_back(v < 0 ? -step : step);
+                        }
+                        pattern.transformed_coeffs.push_back(row);
+                    }
+                    for (unsigned l = 0; l < stmt->trans->nrows; l++) {
+                        pattern.transformed_is_loop.push_back(
+                            pluto_is_hyperplane_loop(stmt, l) != 0);
+                    }
+                    pluto_matrix_free(newacc);
+                }
+                free(divs);
+            }
+            
+            // Extents only from set_array_extents; otherwise reported unknown
+            auto ext = array_extents_.find(pattern.array_name);
+            if (ext != array_extents_.end() && ext->second.size() == acc->mat->nrows) {
+                pattern.extents = ext->second;
+                pattern.dimension_size = pattern.extents.back();
+            } else {
+                pattern.dimension_size = kUnknownExtent;
+            }
+            
+            // Same array + same subscripts read and written: read-modify-write
+            for (auto& existing : patterns) {
+                if (existing.array_name == pattern.array_name &&
+                    existing.coeffs == pattern.coeffs &&
+                    existing.iterator_names == pattern.iterator_names) {
+                    existing.access_frequency = 2;
+                    existing.is_write = existing.is_write || is_write;
+                    return;
+                }
+            }
+            patterns.push_back(pattern);
+        };
+        
+        for (int w = 0; w < stmt->nwrites; w++) {
+            add_access(stmt->writes[w], true);
+        }
+        for (int r = 0; r < stmt->nreads; r++) {
+            add_access(stmt->reads[r], false);
+        }
+    }
+    
+    return patterns;
+}
+
+// NEW: 
+std::vector<size_t> PlutoConstraintSolver::filter_by_constraints(
+    std::vector<ScheduleConfig>& candidates
+) {
+    ScopedPhase phase(PHASE_FILTERING);
+    
+    // Score the whole batch at once; configs that do not fit the packed
+    // layout fall back to the per-config checks
+    CandidateBatch batch;
+    batch.reserve(candidates.size());
+    std::vector<int> slot(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+        slot[i] = batch.add(candidates[i]);
+    }
+    CandidateBatchScorer scorer(*this);
+    scorer.score_coalescing(batch);
+    scorer.score_conflicts(batch);
+    
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        ScheduleConfig& config = candidates[i];
+        
+        bool has_coalescing;
         int conflict_way = 1;
-        check_bank_conflict(config, conflict_way);
+        if (slot[i] >= 0) {
+            has_coalescing = batch.coalesced[slot[i]] != 0;
+            conflict_way = batch.conflict_way[slot[i]];
+        } else {
+            has_coalescing = satisfies_coalescing_constraint(config);
+            check_bank_conflict(config, conflict_way);
+        }
+        config.has_coalescing_violation = !has_coalescing;
         config.bank_conflict_way = conflict_way;
         config.has_bank_conflict = (conflict_way > 1);
         
-        if (bank_conflict_mode_ == ConstraintMode::HARD_CONSTRAINT && config.has_bank_conflict) {
-            should_keep = false;
+        if (passes_constraints(has_coalescing, conflict_way)) {
+            kept.push_back(i);
         }
-        
-        if (should_keep) {
-            filtered.push_back(config);
+    }
+    
+    log_filtering(candidates.size(), kept.size());
+    return kept;
+}
+
+std::vector<size_t> PlutoConstraintSolver::filter_by_constraints(CandidateBatch& batch) {
+    ScopedPhase phase(PHASE_FILTERING);
+    
+    CandidateBatchScorer scorer(*this);
+    scorer.score_coalescing(batch);
+    scorer.score_conflicts(batch);
+    
+    std::vector<size_t> kept;
+    for (size_t c = 0; c < batch.size(); c++) {
+        if (passes_constraints(batch.coalesced[c] != 0, batch.conflict_way[c])) {
+            kept.push_back(c);
         }
     }
     
-    std::cout << "Search: Constraint Filtering:\n";
-    std::cout << "  • Input candidates:  " << candidates.size() << "\n";
-    std::cout << "  • Filtered out:      " << (candidates.size() - filtered.size()) << "\n";
-    std::cout << "  • Remaining:         " << filtered.size() << "\n";
-    std::cout << "  • Coalescing mode:   ";
+    log_filtering(batch.size(), kept.size());
+    return kept;
+}
+
+bool PlutoConstraintSolver::passes_constraints(bool has_coalescing, int conflict_way) const {
+    if (coalescing_mode_ == ConstraintMode::HARD_CONSTRAINT && !has_coalescing) {
+        return false;
+    }
+    if (bank_conflict_mode_ == ConstraintMode::HARD_CONSTRAINT && conflict_way > 1) {
+        return false;
+    }
+    return true;
+}
+
+void PlutoConstraintSolver::log_filtering(size_t num_input, size_t num_kept) {
+    BridgeProfiler::instance().count("candidates_filtered_out", num_input - num_kept);
+    bridge_log() << "Search: Constraint Filtering:\n";
+    bridge_log() << "  • Input candidates:  " << num_input << "\n";
+    bridge_log() << "  • Filtered out:      " << (num_input - num_kept) << "\n";
+    bridge_log() << "  • Remaining:         " << num_kept << "\n";
+    bridge_log() << "  • Coalescing mode:   ";
     switch (coalescing_mode_) {
-        case ConstraintMode::HARD_CONSTRAINT: std::cout << "HARD\n"; break;
-        case ConstraintMode::SOFT_CONSTRAINT: std::cout << "SOFT\n"; break;
-        case ConstraintMode::PENALTY_BASED: std::cout << "PENALTY\n"; break;
-        case ConstraintMode::NO_CONSTRAINT: std::cout << "NONE\n"; break;
+        case ConstraintMode::HARD_CONSTRAINT: bridge_log() << "HARD\n"; break;
+        case ConstraintMode::SOFT_CONSTRAINT: bridge_log() << "SOFT\n"; break;
+        case ConstraintMode::PENALTY_BASED: bridge_log() << "PENALTY\n"; break;
+        case ConstraintMode::NO_CONSTRAINT: bridge_log() << "NONE\n"; break;
     }
-    std::cout << "  • Bank conflict mode: ";
+    bridge_log() << "  • Bank conflict mode: ";
     switch (bank_conflict_mode_) {
-        case ConstraintMode::HARD_CONSTRAINT: std::cout << "HARD\n"; break;
-        case ConstraintMode::SOFT_CONSTRAINT: std::cout << "SOFT\n"; break;
-        case ConstraintMode::PENALTY_BASED: std::cout << "PENALTY\n"; break;
-        case ConstraintMode::NO_CONSTRAINT: std::cout << "NONE\n"; break;
+        case ConstraintMode::HARD_CONSTRAINT: bridge_log() << "HARD\n"; break;
+        case ConstraintMode::SOFT_CONSTRAINT: bridge_log() << "SOFT\n"; break;
+        case ConstraintMode::PENALTY_BASED: bridge_log() << "PENALTY\n"; break;
+        case ConstraintMode::NO_CONSTRAINT: bridge_log() << "NONE\n"; break;
     }
-    std::cout << "\n";
-    
-    return filtered;
+    bridge_log() << "\n";
 }
 
 bool PlutoConstraintSolver::is_legal_config(const ScheduleConfig& config) {
+    ScopedPhase phase(PHASE_LEGALITY);
+    BridgeProfiler::instance().count("legality_checks");
+    
     // Check
     if (config.transformations.empty()) return false;
     
     // Checktile sizes
     for (const auto& ts : config.tile_sizes) {
-        if (ts.size <= 0 || ts.size > 1024) return false;
+        if (!is_legal_tile_size(ts.size)) return false;
     }
     
     return true;
 }
 
+// Loop scanned by each hyperplane of stmt->trans ("" for scalar levels).
+// Unimodular schedules: the loop level the exact decomposition leaves the
+// hyperplane on (its derived names keep that iterator as prefix). Otherwise
+// the original iterator for plain (possibly reversed) hyperplanes, else the
+// outermost iterator of the combination not claimed by another level
+static std::vector<std::string> hyperplane_loop_names(const Stmt* stmt) {
+    unsigned nrows = stmt->trans ? stmt->trans->nrows : 0;
+    std::vector<std::string> names(nrows);
+    std::vector<bool> claimed(stmt->dim, false);
+    
+    auto iterator_name = [&](unsigned c) {
+        return (stmt->iterators && stmt->iterators[c]) ? std::string(stmt->iterators[c])
+                                                       : "i" + std::to_string(c);
+    };
+    
+    ScheduleDecomposition decomposition = decompose_statement_schedule(stmt, 0);
+    if (decomposition.exact) {
+        for (unsigned l = 0; l < nrows; l++) {
+            int level = decomposition.level_of_hyperplane[l];
+            if (level >= 0) names[l] = iterator_name(level);
+        }
+        return names;
+    }
+    
+    // Plain hyperplanes first
+    for (unsigned l = 0; l < nrows; l++) {
+        if (pluto_is_hyperplane_scalar(stmt, l)) continue;
+        int nonzero = 0, iter = -1;
+        for (unsigned c = 0; c < stmt->dim; c++) {
+            if (stmt->trans->val[l][c] != 0) {
+                nonzero++;
+                iter = c;
+            }
+        }
+        if (nonzero == 1 && std::abs(stmt->trans->val[l][iter]) == 1 && !claimed[iter]) {
+            names[l] = iterator_name(iter);
+            claimed[iter] = true;
+        }
+    }
+    
+    // Combinations (skews): outermost unclaimed iterator involved
+    for (unsigned l = 0; l < nrows; l++) {
+        if (pluto_is_hyperplane_scalar(stmt, l) || !names[l].empty()) continue;
+        for (unsigned c = 0; c < stmt->dim; c++) {
+            if (stmt->trans->val[l][c] != 0 && !claimed[c]) {
+                names[l] = iterator_name(c);
+                claimed[c] = true;
+                break;
+            }
+        }
+        if (names[l].empty()) names[l] = "t" + std::to_string(l + 1);
+    }
+    
+    return names;
+}
+
 ScheduleConfig PlutoConstraintSolver::pluto_prog_to_config(PlutoProg* prog) {
     ScheduleConfig config;
     
@@ -414,310 +1386,2994 @@ ScheduleConfig PlutoConstraintSolver::pluto_prog_to_config(PlutoProg* prog) {
     int ndims = prog->nvar;
     Stmt* stmt = prog->stmts[0];
     
-    for (int i = 0; i < ndims; i++) {
-        Transformation trans(TRANS_INTERCHANGE);
+    if (prog->nstmts < 2 || !stmt->trans) {
+        // Loop order of the (transformed) nest, original order if unknown
+        std::vector<std::string> order;
+        if (stmt->trans) {
+            for (const auto& name : hyperplane_loop_names(stmt)) {
+                if (!name.empty()) order.push_back(name);
+            }
+        }
+        if (order.size() == stmt->dim) {
+            // Skews / reversals of the exact decomposition, then the loop order
+            if (stmt->trans) {
+                config.transformations = decompose_statement_schedule(stmt, 0).steps;
+            }
+            for (const auto& name : order) {
+                Transformation trans(TRANS_INTERCHANGE);
+                trans.iterator_names.push_back(name);
+                config.transformations.push_back(trans);
+            }
+            return config;
+        }
+        
+        for (int i = 0; i < ndims; i++) {
+            Transformation trans(TRANS_INTERCHANGE);
+            
+            // 
+            if (stmt->iterators && stmt->iterators[i]) {
+                trans.iterator_names.push_back(stmt->iterators[i]);
+            }
+            
+            config.transformations.push_back(trans);
+        }
+        return config;
+    }
+    
+    // Multi-statement: scalar hyperplanes give each statement's position
+    // (fusion / distribution), loop hyperplanes its skews and loop order
+    std::vector<std::vector<int64_t>> timestamps(prog->nstmts);
+    std::vector<StatementSchedule> schedules;
+    
+    for (int s = 0; s < prog->nstmts; s++) {
+        Stmt* st = prog->stmts[s];
+        StatementSchedule sched;
+        sched.statement_id = s;
         
-        // 
-        if (stmt->iterators && stmt->iterators[i]) {
-            trans.iterator_names.push_back(stmt->iterators[i]);
+        std::vector<std::string> names = hyperplane_loop_names(st);
+        std::vector<Transformation> steps = decompose_statement_schedule(st, s).steps;
+        config.transformations.insert(config.transformations.end(), steps.begin(), steps.end());
+        for (unsigned l = 0; st->trans && l < st->trans->nrows; l++) {
+            if (pluto_is_hyperplane_scalar(st, l)) {
+                int64_t pos = st->trans->val[l][st->trans->ncols - 1];
+                sched.scalar_dims.push_back(pos);
+                timestamps[s].push_back(pos);
+            } else {
+                sched.loop_order.push_back(names[l]);
+                timestamps[s].push_back(0);  // shared loop level
+            }
         }
+        schedules.push_back(sched);
+    }
+    
+    std::stable_sort(schedules.begin(), schedules.end(),
+        [&](const StatementSchedule& a, const StatementSchedule& b) {
+            return timestamps[a.statement_id] < timestamps[b.statement_id];
+        });
+    
+    // Loops shared with the previous statement: loop levels before the
+    // first scalar hyperplane that separates them
+    for (size_t i = 1; i < schedules.size(); i++) {
+        const auto& prev = timestamps[schedules[i - 1].statement_id];
+        const auto& cur = timestamps[schedules[i].statement_id];
+        Stmt* prev_stmt = prog->stmts[schedules[i - 1].statement_id];
         
-        config.transformations.push_back(trans);
+        int fused = 0;
+        for (size_t l = 0; l < std::min(prev.size(), cur.size()); l++) {
+            if (prev[l] != cur[l]) break;
+            if (pluto_is_hyperplane_loop(prev_stmt, l)) fused++;
+        }
+        schedules[i].fused_loops = std::min<int>(fused, schedules[i].loop_order.size());
+    }
+    
+    // Statement 0's nest also drives the single-nest transformations
+    for (const auto& sched : schedules) {
+        if (sched.statement_id != 0) continue;
+        for (const auto& name : sched.loop_order) {
+            Transformation trans(TRANS_INTERCHANGE);
+            trans.iterator_names.push_back(name);
+            config.transformations.push_back(trans);
+        }
     }
     
+    config.statements = schedules;
     return config;
 }
 
-std::vector<int> PlutoConstraintSolver::generate_tile_size_variants(int base_size) {
-    return {base_size / 2, base_size, base_size * 2};
+// Extent of an array dimension indexed by this loop alone (kUnknownExtent
+// if no such dimension has a known extent)
+static int64_t array_extent_of_loop(
+    const std::string& loop,
+    const std::vector<AccessPattern>& patterns
+) {
+    for (const auto& pattern : patterns) {
+        size_t ndims = pattern.has_affine_access() ? pattern.coeffs.size()
+                                                   : pattern.indices.size();
+        for (size_t r = 0; r < ndims; r++) {
+            bool only_loop = false;
+            if (pattern.has_affine_access()) {
+                int nonzero = 0;
+                for (size_t c = 0; c < pattern.iterator_names.size(); c++) {
+                    if (pattern.coeffs[r][c] == 0) continue;
+                    nonzero++;
+                    only_loop = (pattern.iterator_names[c] == loop &&
+                                 std::abs(pattern.coeffs[r][c]) == 1);
+                }
+                only_loop = only_loop && nonzero == 1;
+            } else {
+                only_loop = (pattern.indices[r] == loop);
+            }
+            if (only_loop && pattern.extent(r) > 0) {
+                return pattern.extent(r);
+            }
+        }
+    }
+    
+    return kUnknownExtent;
 }
 
-void PlutoConstraintSolver::print_pluto_prog_info(PlutoProg* prog, const std::string& title) {
-    if (!prog) {
-        std::cout << "WARNING  NULL PlutoProg\n";
-        return;
+// Bytes of every array touched by one tile (loops missing from tile span
+// their whole array dimension; infinite if that extent is unknown)
+static double tile_footprint_bytes(
+    const std::map<std::string, int64_t>& tile,
+    const std::vector<AccessPattern>& patterns
+) {
+    double footprint = 0.0;
+    for (const auto& pattern : patterns) {
+        size_t ndims = pattern.has_affine_access() ? pattern.coeffs.size()
+                                                   : pattern.indices.size();
+        double tile_elems = 1.0;
+        for (size_t r = 0; r < ndims; r++) {
+            int64_t extent = pattern.extent(r);
+            int64_t span = 1;
+            bool whole = false;
+            if (pattern.has_affine_access()) {
+                for (size_t c = 0; c < pattern.iterator_names.size(); c++) {
+                    if (pattern.coeffs[r][c] == 0) continue;
+                    auto t = tile.find(pattern.iterator_names[c]);
+                    if (t == tile.end()) {
+                        whole = true;
+                    } else {
+                        span += std::abs(pattern.coeffs[r][c]) * (t->second - 1);
+                    }
+                }
+            } else {
+                auto t = tile.find(pattern.indices[r]);
+                if (t == tile.end()) whole = true;
+                else span = t->second;
+            }
+            if (extent < 0) {
+                if (whole) return std::numeric_limits<double>::infinity();
+                tile_elems *= span;
+            } else {
+                tile_elems *= whole ? extent : std::min(span, extent);
+            }
+        }
+        footprint += tile_elems * pattern.element_size;
+    }
+    return footprint;
+}
+
+// L1D, L2 and L3 capacity of this machine (sysconf), with common defaults
+static std::vector<int64_t> cache_capacities() {
+    std::vector<int64_t> capacity = {32 * 1024, 1024 * 1024, 32 * 1024 * 1024};
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    long caches[3] = {sysconf(_SC_LEVEL1_DCACHE_SIZE),
+                      sysconf(_SC_LEVEL2_CACHE_SIZE),
+                      sysconf(_SC_LEVEL3_CACHE_SIZE)};
+    for (int l = 0; l < 3; l++) {
+        if (caches[l] > 0) capacity[l] = caches[l];
+    }
+#endif
+    return capacity;
+}
+
+std::vector<ScheduleConfig::TileSize> PlutoConstraintSolver::model_tile_sizes(PlutoProg* prog) {
+    std::vector<ScheduleConfig::TileSize> sizes;
+    if (!prog || prog->nstmts == 0 || prog->num_hyperplanes == 0 || !prog->stmts[0]->trans) {
+        return sizes;
     }
     
-    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-    std::cout << "  " << title << "\n";
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
-    
-    std::cout << "Stats: Program Statistics:\n";
-    std::cout << "  • Number of variables:  " << prog->nvar << "\n";
-    std::cout << "  • Number of statements: " << prog->nstmts << "\n";
-    std::cout << "  • Number of parameters: " << prog->npar << "\n\n";
+    unsigned nbands = 0;
+    Band** bands = pluto_get_outermost_permutable_bands(prog, &nbands);
     
-    if (prog->nstmts > 0 && prog->stmts) {
-        std::cout << "Info: Statements:\n";
-        for (int s = 0; s < prog->nstmts; s++) {
-            Stmt* stmt = prog->stmts[s];
-            if (!stmt) continue;
+    for (unsigned b = 0; b < nbands; b++) {
+        Band* band = bands[b];
+        std::vector<int> band_sizes(band->width, 0);
+        find_tile_sizes(band, prog, band_sizes.data());
+        
+        Stmt* stmt = band->loop->stmts[0];
+        std::vector<std::string> names = hyperplane_loop_names(stmt);
+        for (unsigned i = 0; i < band->width; i++) {
+            unsigned level = band->loop->depth + i;
+            if (!pluto_is_hyperplane_loop(stmt, level)) continue;  // scalar (size 42)
             
-            std::cout << "\n  Statement " << s << ":\n";
-            std::cout << "    Dimensions: " << stmt->dim << "\n";
+            const std::string& name = names[level];
             
-            if (stmt->iterators) {
-                std::cout << "    Iterators:  ";
-                for (int i = 0; i < stmt->dim; i++) {
-                    if (stmt->iterators[i]) {
-                        std::cout << stmt->iterators[i];
-                        if (i < stmt->dim - 1) std::cout << ", ";
-                    }
-                }
-                std::cout << "\n";
-            }
+            bool seen = false;
+            for (const auto& ts : sizes) seen = seen || ts.loop_name == name;
+            if (seen) continue;
             
-            if (stmt->trans) {
-                std::cout << "    Transformation Matrix:\n";
-                for (int i = 0; i < stmt->dim; i++) {
-                    std::cout << "      [";
-                    for (int j = 0; j < stmt->dim + 1; j++) {
-                        printf("%4lld", stmt->trans->val[i][j]);
-                        if (j < stmt->dim) std::cout << " ";
-                    }
-                    std::cout << " ]\n";
-                }
-                
-                // loops
-                std::cout << "\n    Loop Order Analysis:\n";
-                for (int i = 0; i < stmt->dim; i++) {
-                    std::cout << "      Level " << i << ": ";
-                    
-                    //  
-                    for (int j = 0; j < stmt->dim; j++) {
-                        if (stmt->trans->val[i][j] != 0) {
-                            if (stmt->iterators && stmt->iterators[j]) {
-                                std::cout << stmt->iterators[j];
-                                if (stmt->trans->val[i][j] > 1) {
-                                    std::cout << " (scaled by " << stmt->trans->val[i][j] << ")";
-                                }
-                            }
-                            std::cout << " ";
-                        }
-                    }
-                    
-                    // innermost
-                    if (i == stmt->dim - 1) {
-                        std::cout << " ← innermost (coalescing)";
-                    }
-                    std::cout << "\n";
+            ScheduleConfig::TileSize ts;
+            ts.loop_name = name;
+            ts.size = band_sizes[i];
+            sizes.push_back(ts);
+        }
+    }
+    
+    pluto_bands_free(bands, nbands);
+    
+    bridge_log() << "Model: PLUTO tile size model:";
+    for (const auto& ts : sizes) bridge_log() << " " << ts.loop_name << "=" << ts.size;
+    bridge_log() << "\n";
+    
+    return sizes;
+}
+
+std::vector<std::vector<ScheduleConfig::TileSize>> PlutoConstraintSolver::hierarchy_tile_levels(
+    const std::vector<ScheduleConfig::TileSize>& inner
+) const {
+    std::vector<std::vector<ScheduleConfig::TileSize>> levels;
+    if (inner.empty() || access_patterns_.empty()) return levels;
+    
+    // Half of the private L2, half of a core's share of the shared L3
+    std::vector<int64_t> capacity = cache_capacities();
+    int64_t cores = std::max(1u, std::thread::hardware_concurrency());
+    int64_t budgets[2] = {capacity[1] / 2, capacity[2] / (2 * cores)};
+    
+    std::vector<ScheduleConfig::TileSize> current = inner;
+    for (int64_t budget : budgets) {
+        // Double the loops round-robin while the tile fits and stays
+        // smaller than the loop
+        std::vector<ScheduleConfig::TileSize> level = current;
+        std::map<std::string, int64_t> tile;
+        for (const auto& ts : level) tile[ts.loop_name] = std::max(1, ts.size);
+        
+        bool grown = true, changed = false;
+        while (grown) {
+            grown = false;
+            for (auto& ts : level) {
+                if (ts.size <= 0) continue;
+                int64_t extent = array_extent_of_loop(ts.loop_name, access_patterns_);
+                if (extent > 0 && 2 * (int64_t)ts.size >= extent) continue;
+                tile[ts.loop_name] = 2 * (int64_t)ts.size;
+                if (tile_footprint_bytes(tile, access_patterns_) > budget) {
+                    tile[ts.loop_name] = ts.size;
+                    continue;
                 }
+                ts.size *= 2;
+                grown = changed = true;
             }
-            
-            if (stmt->text) {
-                std::cout << "\n    Text: " << stmt->text << "\n";
+        }
+        if (!changed) break;
+        
+        levels.insert(levels.begin(), level);
+        current = level;
+    }
+    
+    if (!levels.empty()) {
+        bridge_log() << "Model: " << levels.size() << " outer tile level(s):";
+        for (const auto& level : levels) {
+            bridge_log() << " [";
+            for (size_t d = 0; d < level.size(); d++) {
+                bridge_log() << (d ? " " : "") << level[d].loop_name << "=" << level[d].size;
             }
+            bridge_log() << "]";
+        }
+        bridge_log() << "\n";
+    }
+    return levels;
+}
+
+std::vector<Transformation> PlutoConstraintSolver::parallel_transformations(
+    PlutoProg* prog,
+    const std::vector<ScheduleConfig::TileSize>& outer_tiles
+) {
+    std::vector<Transformation> transforms;
+    std::vector<BandParallelism> parallelism = find_parallel_loops(prog);
+    if (parallelism.empty()) return transforms;
+    
+    std::vector<ScheduleConfig::TileSize> tiles = outer_tiles.empty() ? model_tile_sizes(prog)
+                                                                      : outer_tiles;
+    int64_t cores = std::max(1u, std::thread::hardware_concurrency());
+    
+    for (const auto& par : parallelism) {
+        if (par.statement_id < 0 || par.statement_id >= prog->nstmts) continue;
+        const Stmt* stmt = prog->stmts[par.statement_id];
+        // Inexact schedules are lowered as t<l> loops the tags cannot name
+        if (!decompose_statement_schedule(stmt, par.statement_id).exact) continue;
+        std::vector<std::string> names = hyperplane_loop_names(stmt);
+        if (names[par.level].empty() ||
+            (par.inner_level >= 0 && names[par.inner_level].empty())) continue;
+        
+        Transformation trans(TRANS_PARALLELIZE);
+        trans.iterator_names.push_back(names[par.level]);
+        trans.statement_id = par.statement_id;
+        if (par.wavefront) {
+            trans.iterator_names.push_back(names[par.inner_level]);
+        }
+        transforms.push_back(trans);
+        if (par.wavefront || par.inner_level < 0) continue;
+        
+        // Fewer outer tiles than cores: the next parallel loop runs in
+        // parallel too (nested parallel loops; Tiramisu has no CPU collapse)
+        int64_t tile = 1;
+        for (const auto& ts : tiles) {
+            if (ts.loop_name == names[par.level] && ts.size > 0) tile = ts.size;
+        }
+        int64_t extent = array_extent_of_loop(names[par.level], access_patterns_);
+        if (extent <= 0) continue;
+        int64_t outer_tiles = (extent + tile - 1) / tile;
+        if (outer_tiles < cores) {
+            Transformation inner(TRANS_PARALLELIZE);
+            inner.iterator_names.push_back(names[par.inner_level]);
+            inner.statement_id = par.statement_id;
+            transforms.push_back(inner);
+        }
+    }
+    
+    bridge_log() << "Model: " << transforms.size() << " parallel loop(s) from PLUTO's bands\n";
+    return transforms;
+}
+
+bool PlutoConstraintSolver::select_vectorization(
+    const ScheduleConfig& config,
+    const VectorISA& isa,
+    Transformation& vectorize
+) const {
+    std::string loop = innermost_loop_name(config);
+    if (loop.empty() || access_patterns_.empty()) return false;
+    
+    // Skewed / reversed inner loops scan arrays along a diagonal or backwards
+    for (const auto& trans : config.transformations) {
+        if ((trans.type == TRANS_SKEW || trans.type == TRANS_REVERSE ||
+             trans.type == TRANS_PARALLELIZE) &&
+            std::find(trans.iterator_names.begin(), trans.iterator_names.end(),
+                      loop) != trans.iterator_names.end()) {
+            return false;
+        }
+    }
+    
+    // Unit-stride or invariant accesses only (no gathers / scatters)
+    size_t element_bytes = 0;
+    for (const auto& pattern : access_patterns_) {
+        if (compute_stride_for_pattern(config, pattern) > 1) return false;
+        element_bytes = std::max(element_bytes, pattern.element_size);
+    }
+    
+    int64_t trip = 0;
+    for (const auto& trans : config.transformations) {
+        if (trans.type != TRANS_TILE || !config.tile_sizes.empty()) continue;
+        for (size_t d = 0; d < trans.iterator_names.size() && d < trans.tile_sizes.size(); d++) {
+            if (trans.iterator_names[d] == loop) trip = trans.tile_sizes[d];
+        }
+    }
+    for (const auto& ts : config.tile_sizes) {
+        if (ts.loop_name == loop && ts.size > 0) trip = ts.size;
+    }
+    if (trip <= 0) trip = array_extent_of_loop(loop, access_patterns_);
+    
+    int factor = isa.lanes(element_bytes);
+    while (factor > 1 && trip > 0 && factor > trip) factor /= 2;
+    if (factor < 2) return false;
+    
+    vectorize = Transformation(TRANS_VECTORIZE);
+    vectorize.iterator_names.push_back(loop);
+    vectorize.factor = factor;
+    return true;
+}
+
+// Whether the access subscripts depend on the loop
+static bool access_uses_loop(const AccessPattern& pattern, const std::string& loop) {
+    if (!pattern.has_affine_access()) {
+        return std::find(pattern.indices.begin(), pattern.indices.end(), loop) !=
+               pattern.indices.end();
+    }
+    auto it = std::find(pattern.iterator_names.begin(), pattern.iterator_names.end(), loop);
+    if (it == pattern.iterator_names.end()) return false;
+    size_t col = it - pattern.iterator_names.begin();
+    for (const auto& row : pattern.coeffs) {
+        if (col < row.size() && row[col] != 0) return true;
+    }
+    return false;
+}
+
+std::vector<std::vector<ScheduleConfig::TileSize>> PlutoConstraintSolver::unroll_jam_variants(
+    const ScheduleConfig& config,
+    const VectorISA& isa,
+    size_t max_variants
+) const {
+    std::vector<std::vector<ScheduleConfig::TileSize>> variants;
+    if (access_patterns_.empty() || config.statements.size() >= 2 ||
+        config.tile_sizes.empty() || max_variants == 0) {
+        return variants;
+    }
+    std::vector<std::string> order = explicit_loop_order(config);
+    if (order.size() < 2) return variants;
+    
+    // Register reuse needs an access invariant in the innermost loop
+    // (t > 0 in PLUTO's is_unroll_jam_profitable) ...
+    auto invariant_in = [&](const std::string& loop) {
+        for (const auto& pattern : access_patterns_) {
+            if (!access_uses_loop(pattern, loop)) return true;
+        }
+        return false;
+    };
+    if (!invariant_in(order.back())) return variants;
+    
+    // ... and, per jammed loop, one shared by its copies. Jammed loops are
+    // the tiled loops directly outside the innermost one.
+    std::vector<std::string> loops;
+    std::vector<int> tiles;
+    for (size_t d = order.size() - 1; d-- > 0 && loops.size() < 2;) {
+        int tile = 0;
+        for (const auto& ts : config.tile_sizes) {
+            if (ts.loop_name == order[d]) tile = ts.size;
+        }
+        if (tile <= 1 || !invariant_in(order[d])) break;
+        loops.insert(loops.begin(), order[d]);
+        tiles.insert(tiles.begin(), tile);
+    }
+    if (loops.empty()) return variants;
+    
+    // Factors: powers of two up to PLUTO's unroll-jam factor that divide
+    // the tile (no partial register tiles)
+    int max_factor = (options_ && options_->ufactor > 1) ? options_->ufactor : 8;
+    std::vector<std::vector<int>> choices(loops.size());
+    for (size_t l = 0; l < loops.size(); l++) {
+        for (int f = 1; f <= max_factor && f <= tiles[l]; f *= 2) {
+            if (tiles[l] % f == 0) choices[l].push_back(f);
+        }
+    }
+    
+    // With SIMD, an access invariant in the innermost (vector) loop is a
+    // broadcast scalar: it is re-broadcast from memory at each use (one load,
+    // or the FMA's memory operand) and needs a single transient register
+    // shared by all of them, not one vector register per copy. Without SIMD
+    // every access is a scalar kept per copy.
+    bool simd = isa.width_bytes > 0;
+    
+    struct Jam {
+        std::vector<int> factors;
+        int copies;      // Jammed iterations per register tile
+        int registers;   // One per vector access and jammed copy it varies in,
+                         // plus one shared by the broadcast scalars
+    };
+    std::vector<Jam> jams;
+    if (loops.size() < 2) choices.push_back({1});
+    for (int f0 : choices[0]) {
+        for (int f1 : choices[1]) {
+            Jam jam;
+            jam.factors = {f0, f1};
+            jam.factors.resize(loops.size());
+            jam.copies = f0 * f1;
+            jam.registers = 0;
+            bool broadcast = false;
+            for (const auto& pattern : access_patterns_) {
+                if (simd && !pattern.is_write && !access_uses_loop(pattern, order.back())) {
+                    broadcast = true;
+                    continue;
+                }
+                int copies = 1;
+                for (size_t l = 0; l < loops.size(); l++) {
+                    if (access_uses_loop(pattern, loops[l])) copies *= jam.factors[l];
+                }
+                jam.registers += copies;
+            }
+            if (broadcast) jam.registers++;
+            if (jam.copies > 1 && jam.registers <= isa.registers) jams.push_back(jam);
+        }
+    }
+    
+    // Most jammed copies first; fewer registers, then balanced factors on ties
+    std::sort(jams.begin(), jams.end(), [](const Jam& a, const Jam& b) {
+        if (a.copies != b.copies) return a.copies > b.copies;
+        if (a.registers != b.registers) return a.registers < b.registers;
+        int spread_a = *std::max_element(a.factors.begin(), a.factors.end()) -
+                       *std::min_element(a.factors.begin(), a.factors.end());
+        int spread_b = *std::max_element(b.factors.begin(), b.factors.end()) -
+                       *std::min_element(b.factors.begin(), b.factors.end());
+        return spread_a < spread_b;
+    });
+    
+    for (size_t j = 0; j < jams.size() && variants.size() < max_variants; j++) {
+        std::vector<ScheduleConfig::TileSize> jam;
+        for (size_t l = 0; l < loops.size(); l++) {
+            ScheduleConfig::TileSize ts;
+            ts.loop_name = loops[l];
+            ts.size = jams[j].factors[l];
+            jam.push_back(ts);
+        }
+        variants.push_back(jam);
+    }
+    return variants;
+}
+
+std::vector<std::vector<ScheduleConfig::TileSize>> PlutoConstraintSolver::tile_size_neighbourhood(
+    const std::vector<ScheduleConfig::TileSize>& seed,
+    size_t max_variants
+) {
+    std::vector<std::vector<ScheduleConfig::TileSize>> variants;
+    if (seed.empty()) return variants;
+    
+    auto add = [&](const std::vector<ScheduleConfig::TileSize>& sizes) {
+        for (const auto& v : variants) {
+            bool same = true;
+            for (size_t d = 0; d < sizes.size(); d++) same = same && v[d].size == sizes[d].size;
+            if (same) return;
+        }
+        variants.push_back(sizes);
+    };
+    auto scaled = [](int size, double factor) {
+        return std::max(2, (int)std::lround(size * factor));
+    };
+    
+    add(seed);
+    
+    // One dimension at a time: keeps the model's aspect ratio elsewhere
+    const double single[] = {0.5, 1.5, 0.75, 2.0};
+    for (double factor : single) {
+        for (size_t d = 0; d < seed.size(); d++) {
+            std::vector<ScheduleConfig::TileSize> sizes = seed;
+            sizes[d].size = scaled(seed[d].size, factor);
+            add(sizes);
+        }
+    }
+    
+    // Whole tile shrunk / grown
+    for (double factor : {0.5, 2.0}) {
+        std::vector<ScheduleConfig::TileSize> sizes = seed;
+        for (auto& ts : sizes) ts.size = scaled(ts.size, factor);
+        add(sizes);
+    }
+    
+    if (variants.size() > max_variants) variants.resize(max_variants);
+    return variants;
+}
+
+std::vector<int> PlutoConstraintSolver::generate_tile_size_variants(int base_size) {
+    return {base_size / 2, base_size, base_size * 2};
+}
+
+void PlutoConstraintSolver::print_pluto_prog_info(PlutoProg* prog, const std::string& title) {
+    if (!prog) {
+        std::cout << "WARNING  NULL PlutoProg\n";
+        return;
+    }
+    
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    std::cout << "  " << title << "\n";
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    
+    std::cout << "Stats: Program Statistics:\n";
+    std::cout << "  • Number of variables:  " << prog->nvar << "\n";
+    std::cout << "  • Number of statements: " << prog->nstmts << "\n";
+    std::cout << "  • Number of parameters: " << prog->npar << "\n\n";
+    
+    if (prog->nstmts > 0 && prog->stmts) {
+        std::cout << "Info: Statements:\n";
+        for (int s = 0; s < prog->nstmts; s++) {
+            Stmt* stmt = prog->stmts[s];
+            if (!stmt) continue;
+            
+            std::cout << "\n  Statement " << s << ":\n";
+            std::cout << "    Dimensions: " << stmt->dim << "\n";
+            
+            if (stmt->iterators) {
+                std::cout << "    Iterators:  ";
+                for (int i = 0; i < stmt->dim; i++) {
+                    if (stmt->iterators[i]) {
+                        std::cout << stmt->iterators[i];
+                        if (i < stmt->dim - 1) std::cout << ", ";
+                    }
+                }
+                std::cout << "\n";
+            }
+            
+            if (stmt->trans) {
+                std::cout << "    Transformation Matrix:\n";
+                for (int i = 0; i < stmt->dim; i++) {
+                    std::cout << "      [";
+                    for (int j = 0; j < stmt->dim + 1; j++) {
+                        printf("%4lld", stmt->trans->val[i][j]);
+                        if (j < stmt->dim) std::cout << " ";
+                    }
+                    std::cout << " ]\n";
+                }
+                
+                // loops
+                std::cout << "\n    Loop Order Analysis:\n";
+                for (int i = 0; i < stmt->dim; i++) {
+                    std::cout << "      Level " << i << ": ";
+                    
+                    //  
+                    for (int j = 0; j < stmt->dim; j++) {
+                        if (stmt->trans->val[i][j] != 0) {
+                            if (stmt->iterators && stmt->iterators[j]) {
+                                std::cout << stmt->iterators[j];
+                                if (stmt->trans->val[i][j] > 1) {
+                                    std::cout << " (scaled by " << stmt->trans->val[i][j] << ")";
+                                }
+                            }
+                            std::cout << " ";
+                        }
+                    }
+                    
+                    // innermost
+                    if (i == stmt->dim - 1) {
+                        std::cout << " ← innermost (coalescing)";
+                    }
+                    std::cout << "\n";
+                }
+            }
+            
+            if (stmt->text) {
+                std::cout << "\n    Text: " << stmt->text << "\n";
+            }
+        }
+    }
+    
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+}
+
+// ============================================================================
+// LegalConfigEnumerator Implementation
+// ============================================================================
+
+LegalConfigEnumerator::LegalConfigEnumerator(
+    PlutoConstraintSolver* solver,
+    PlutoProg* prog,
+    const std::vector<std::string>& loop_names,
+    const std::vector<int>& tile_options,
+    bool only_coalesced
+) : solver_(solver), loop_names_(loop_names), tile_options_(tile_options),
+    only_coalesced_(only_coalesced) {
+    if (tile_options_.empty()) {
+        tile_options_.push_back(32);
+    }
+    compute_dependence_directions(prog);
+    reset();
+}
+
+// Dependence directions along the *original* loops: temporarily give every
+// statement an identity schedule, let PLUTO compute the directions, then
+// restore the real schedule (and its dirvecs)
+void LegalConfigEnumerator::compute_dependence_directions(PlutoProg* prog) {
+    size_t n = loop_names_.size();
+    dep_dirs_.clear();
+    if (!prog || prog->ndeps == 0) return;
+    
+    std::vector<PlutoMatrix*> saved_trans(prog->nstmts);
+    int saved_num_hyperplanes = prog->num_hyperplanes;
+    
+    for (unsigned s = 0; s < prog->nstmts; s++) {
+        Stmt* stmt = prog->stmts[s];
+        saved_trans[s] = stmt->trans;
+        
+        PlutoMatrix* id = pluto_matrix_alloc(n, stmt->dim + prog->npar + 1,
+                                             prog->context);
+        pluto_matrix_set(id, 0);
+        for (size_t l = 0; l < n && l < stmt->dim; l++) {
+            id->val[l][l] = 1;
+        }
+        stmt->trans = id;
+    }
+    prog->num_hyperplanes = n;
+    
+    pluto_compute_dep_directions(prog);
+    
+    for (int d = 0; d < prog->ndeps; d++) {
+        Dep* dep = prog->deps[d];
+        if (IS_RAR(dep->type)) continue;  // Reads never constrain order
+        
+        std::vector<char> dirs(n);
+        for (size_t l = 0; l < n; l++) {
+            dirs[l] = (char)dep->dirvec[l];
+        }
+        dep_dirs_.push_back(dirs);
+    }
+    
+    bool had_schedule = true;
+    for (unsigned s = 0; s < prog->nstmts; s++) {
+        pluto_matrix_free(prog->stmts[s]->trans);
+        prog->stmts[s]->trans = saved_trans[s];
+        had_schedule = had_schedule && saved_trans[s] != nullptr;
+    }
+    prog->num_hyperplanes = saved_num_hyperplanes;
+    if (had_schedule && saved_num_hyperplanes > 0) {
+        pluto_compute_dep_directions(prog);
+    }
+}
+
+void LegalConfigEnumerator::reset() {
+    size_t n = loop_names_.size();
+    perm_.assign(n, -1);
+    cursor_.assign(n + 1, 0);
+    used_.assign(n, false);
+    satisfied_.assign(n + 1, std::vector<bool>(dep_dirs_.size(), false));
+    depth_ = 0;
+    started_ = false;
+    exhausted_ = (n == 0);
+    have_perm_ = false;
+    tile_index_.assign(n, 0);
+    num_permutations_ = 0;
+    num_pruned_prefixes_ = 0;
+}
+
+// A loop may be placed at this depth if no dependence that is still
+// unsatisfied by the prefix runs backwards (or unknown) along it
+bool LegalConfigEnumerator::can_place(int loop, int depth) {
+    for (size_t d = 0; d < dep_dirs_.size(); d++) {
+        if (satisfied_[depth][d]) continue;
+        char dir = dep_dirs_[d][loop];
+        if (dir == DEP_MINUS || dir == DEP_STAR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LegalConfigEnumerator::place(int loop, int depth) {
+    perm_[depth] = loop;
+    used_[loop] = true;
+    for (size_t d = 0; d < dep_dirs_.size(); d++) {
+        satisfied_[depth + 1][d] = satisfied_[depth][d] ||
+                                   dep_dirs_[d][loop] == DEP_PLUS;
+    }
+}
+
+// Iterative DFS: returns the next complete legal permutation
+bool LegalConfigEnumerator::advance_permutation() {
+    int n = (int)loop_names_.size();
+    
+    if (!started_) {
+        started_ = true;
+        depth_ = 0;
+        cursor_[0] = 0;
+    } else {
+        // Backtrack from the last complete permutation
+        depth_ = n - 1;
+        used_[perm_[depth_]] = false;
+    }
+    
+    while (depth_ >= 0) {
+        bool found = false;
+        for (int c = cursor_[depth_]; c < n; c++) {
+            if (used_[c]) continue;
+            if (!can_place(c, depth_)) {
+                num_pruned_prefixes_++;
+                continue;
+            }
+            place(c, depth_);
+            cursor_[depth_] = c + 1;
+            found = true;
+            break;
+        }
+        
+        if (found) {
+            if (depth_ == n - 1) {
+                return true;
+            }
+            depth_++;
+            cursor_[depth_] = 0;
+        } else {
+            depth_--;
+            if (depth_ >= 0) {
+                used_[perm_[depth_]] = false;
+            }
+        }
+    }
+    
+    return false;
+}
+
+bool LegalConfigEnumerator::advance_tiles() {
+    for (size_t d = 0; d < tile_index_.size(); d++) {
+        if (++tile_index_[d] < tile_options_.size()) {
+            return true;
+        }
+        tile_index_[d] = 0;
+    }
+    return false;
+}
+
+ScheduleConfig LegalConfigEnumerator::build_config() const {
+    ScheduleConfig config;
+    std::string order, tiles;
+    
+    for (size_t depth = 0; depth < perm_.size(); depth++) {
+        const std::string& name = loop_names_[perm_[depth]];
+        Transformation trans(TRANS_INTERCHANGE);
+        trans.iterator_names.push_back(name);
+        config.transformations.push_back(trans);
+        order += (depth ? "," : "") + name;
+    }
+    
+    // Outermost parallel loop: every dependence the loops above it leave
+    // unsatisfied has distance zero along it
+    for (size_t depth = 0; depth < perm_.size(); depth++) {
+        bool parallel = true;
+        for (size_t d = 0; d < dep_dirs_.size() && parallel; d++) {
+            parallel = satisfied_[depth][d] || dep_dirs_[d][perm_[depth]] == DEP_ZERO;
+        }
+        if (parallel) {
+            Transformation trans(TRANS_PARALLELIZE);
+            trans.iterator_names.push_back(loop_names_[perm_[depth]]);
+            config.transformations.push_back(trans);
+            break;
+        }
+    }
+    
+    for (size_t l = 0; l < loop_names_.size(); l++) {
+        ScheduleConfig::TileSize ts;
+        ts.loop_name = loop_names_[l];
+        ts.size = tile_options_[tile_index_[l]];
+        config.tile_sizes.push_back(ts);
+        tiles += (l ? "x" : "") + std::to_string(ts.size);
+    }
+    
+    config.description = "Loop order (" + order + "), tile " + tiles;
+    return config;
+}
+
+// Step to the next legal (loop order, tile sizes) point. The candidates are
+// interchanges of every loop, so is_legal_config reduces to the tile sizes
+bool LegalConfigEnumerator::advance() {
+    while (!exhausted_) {
+        if (!have_perm_ || !advance_tiles()) {
+            // Next legal loop order (coalescing is a property of the order)
+            have_perm_ = false;
+            while (advance_permutation()) {
+                num_permutations_++;
+                if (!only_coalesced_) {
+                    have_perm_ = true;
+                    break;
+                }
+                ScheduleConfig probe = build_config();
+                if (solver_->satisfies_coalescing_constraint(probe)) {
+                    have_perm_ = true;
+                    break;
+                }
+            }
+            if (!have_perm_) {
+                exhausted_ = true;
+                return false;
+            }
+            std::fill(tile_index_.begin(), tile_index_.end(), 0);
+        }
+        
+        BridgeProfiler::instance().count("legality_checks");
+        bool legal = true;
+        for (size_t l = 0; l < tile_index_.size(); l++) {
+            legal = legal && solver_->is_legal_tile_size(tile_options_[tile_index_[l]]);
+        }
+        if (legal) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LegalConfigEnumerator::next(ScheduleConfig& config) {
+    if (!advance()) return false;
+    config = build_config();
+    return true;
+}
+
+bool LegalConfigEnumerator::next(CandidateBatch& batch) {
+    int n = (int)loop_names_.size();
+    if (n > CandidateBatch::kMaxLoops || !advance()) return false;
+    
+    uint8_t order[CandidateBatch::kMaxLoops];
+    std::pair<uint8_t, uint16_t> tiles[CandidateBatch::kMaxLoops];
+    for (int d = 0; d < n; d++) {
+        order[d] = batch.iterators.intern(loop_names_[perm_[d]]);
+        tiles[d] = std::make_pair(batch.iterators.intern(loop_names_[d]),
+                                  (uint16_t)tile_options_[tile_index_[d]]);
+    }
+    return batch.append(CandidateBatch::ORDER_EXPLICIT, order, n, order[n - 1],
+                        tiles, n) >= 0;
+}
+
+// ============================================================================
+// TiramisuConfigEvaluator Implementation
+// ============================================================================
+
+double TiramisuConfigEvaluator::evaluate_config(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config,
+    int num_runs
+) {
+    MeasurementResult m = measure_config(comp, config, num_runs);
+    if (!m.ok) {
+        return -1.0;
+    }
+    
+    double measured_time = m.median_ms;
+    
+    // NEW: bank conflict
+    if (apply_bank_conflict_penalty_ && config.has_bank_conflict) {
+        measured_time = compute_penalized_score(config, measured_time);
+    }
+    
+    return measured_time;
+}
+
+MeasurementResult TiramisuConfigEvaluator::measure_config(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config,
+    int num_runs
+) {
+    MeasurementResult result;
+    
+    if (!tiramisu_func_) {
+        result.error = "no tiramisu function";
+        return result;
+    }
+    
+    // Start every candidate from the original (unscheduled) computation
+    reset_schedules();
+    if (!apply_config_to_computation(comp, config, result.error)) {
+        reset_schedules();
+        return result;
+    }
+    
+    std::string so_path = compile_to_shared_library(result.error, &result);
+    reset_schedules();
+    if (so_path.empty()) {
+        return result;
+    }
+    
+    MeasurementResult cost = result;
+    result = run_shared_library(so_path, std::max(1, num_runs));
+    result.compile_ms = cost.compile_ms;
+    result.code_size_bytes = cost.code_size_bytes;
+    std::remove(so_path.c_str());
+    
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+// Legality checks
+// ----------------------------------------------------------------------------
+
+// Everything the dependence check depends on: schedule structure and the
+// set of tiled loops (tile sizes do not change legality)
+static std::string legality_key(const ScheduleConfig& config) {
+    std::string key = schedule_signature(config);
+    for (const auto& trans : config.transformations) {
+        key += "/" + std::to_string(trans.factor);
+    }
+    for (const auto& ts : config.tile_sizes) {
+        if (ts.size > 1) key += "#" + ts.loop_name;
+    }
+    for (size_t l = 0; l < config.outer_tile_sizes.size(); l++) {
+        for (const auto& ts : config.outer_tile_sizes[l]) {
+            if (ts.size > 1) key += "#" + std::to_string(l) + ts.loop_name;
+        }
+    }
+    for (const auto& ts : config.unroll_jam) {
+        if (ts.size > 1) key += "%" + ts.loop_name;
+    }
+    return key;
+}
+
+// Whether the config skews or reverses loops
+static bool has_skew_steps(const ScheduleConfig& config) {
+    for (const auto& trans : config.transformations) {
+        if (trans.type == TRANS_SKEW || trans.type == TRANS_REVERSE) return true;
+    }
+    return false;
+}
+
+// RAW / WAR / WAW of the declared program, computed once
+void TiramisuConfigEvaluator::prepare_dependences() {
+    if (deps_ready_) return;
+    tiramisu_func_->prepare_schedules_for_legality_checks(false);
+    tiramisu_func_->perform_full_dependency_analysis();
+    deps_ready_ = true;
+}
+
+// reset_schedules also drops the declared then/after order, so the first
+// reset runs the dependence analysis while that order is still in place
+void TiramisuConfigEvaluator::reset_schedules() {
+    prepare_dependences();
+    tiramisu_func_->reset_schedules();
+}
+
+// Verdicts are per function and computation: the same config can be legal
+// for one statement and not for another
+std::string TiramisuConfigEvaluator::verdict_scope(const tiramisu::computation& comp) const {
+    return tiramisu_func_->get_name() + "/" + comp.get_name() + ":";
+}
+
+bool TiramisuConfigEvaluator::schedule_is_legal(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config
+) {
+    bool legal = false;
+    std::string error;
+    reset_schedules();
+    if (apply_config_to_computation(comp, config, error)) {
+        legality_stats_.isl_checks++;
+        tiramisu_func_->prepare_schedules_for_legality_checks(false);
+        legal = tiramisu_func_->check_legality_for_function();
+    }
+    reset_schedules();
+    return legal;
+}
+
+bool TiramisuConfigEvaluator::check_legality(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config
+) {
+    if (!check_legality_ || !tiramisu_func_) return true;
+    ScopedPhase phase(PHASE_LEGALITY);
+    prepare_dependences();
+    
+    std::string scope = verdict_scope(comp);
+    std::string key = scope + legality_key(config);
+    auto cached = config_verdicts_.find(key);
+    if (cached != config_verdicts_.end()) {
+        legality_stats_.cache_hits++;
+        return cached->second;
+    }
+    
+    bool legal = true;
+    std::vector<std::string> order = explicit_loop_order(config);
+    // Prefix probes reorder unskewed loops: they say nothing about skewed ones
+    if (order.size() >= 2 && config.statements.size() < 2 && !has_skew_steps(config)) {
+        // Original order of the reordered loops (declaration order of comp)
+        reset_schedules();
+        std::vector<std::string> levels = comp.get_loop_level_names();
+        auto position = [&](const std::string& name) {
+            auto it = std::find(levels.begin(), levels.end(),
+                                resolve_loop_name(comp, name, false));
+            return it - levels.begin();
+        };
+        std::vector<std::string> original = order;
+        std::stable_sort(original.begin(), original.end(),
+                         [&](const std::string& a, const std::string& b) {
+                             return position(a) < position(b);
+                         });
+        
+        std::string prefix = scope;
+        for (size_t d = 1; d < order.size() && legal; d++) {
+            prefix += (d > 1 ? "," : "") + order[d - 1];
+            
+            auto hit = prefix_verdicts_.find(prefix);
+            if (hit != prefix_verdicts_.end()) {
+                legality_stats_.cache_hits++;
+                legal = hit->second;
+                if (!legal) legality_stats_.prefix_rejections++;
+                continue;
+            }
+            
+            // Unchanged outer loops: same as the original schedule
+            if (std::equal(order.begin(), order.begin() + d, original.begin())) {
+                prefix_verdicts_[prefix] = true;
+                continue;
+            }
+            
+            // Prefix, then the remaining loops in their original order
+            ScheduleConfig probe;
+            std::vector<std::string> completion(order.begin(), order.begin() + d);
+            for (const auto& name : original) {
+                if (std::find(completion.begin(), completion.end(), name) == completion.end()) {
+                    completion.push_back(name);
+                }
+            }
+            for (const auto& name : completion) {
+                Transformation trans(TRANS_INTERCHANGE);
+                trans.iterator_names.push_back(name);
+                probe.transformations.push_back(trans);
+            }
+            legal = schedule_is_legal(comp, probe);
+            prefix_verdicts_[prefix] = legal;
+        }
+    }
+    
+    if (legal) {
+        legal = schedule_is_legal(comp, config);
+    }
+    config_verdicts_[key] = legal;
+    BridgeProfiler::instance().count(legal ? "legal_candidates" : "illegal_candidates");
+    return legal;
+}
+
+bool TiramisuConfigEvaluator::vectorization_is_legal(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config
+) {
+    if (!tiramisu_func_) return true;
+    ScopedPhase phase(PHASE_LEGALITY);
+    prepare_dependences();
+    
+    // The schedule the vector loop lives in, without the vectorization
+    ScheduleConfig base = config;
+    std::string loop;
+    int statement_id = 0;
+    base.transformations.clear();
+    for (const auto& trans : config.transformations) {
+        if (trans.type == TRANS_VECTORIZE) {
+            if (!trans.iterator_names.empty()) loop = trans.iterator_names[0];
+            statement_id = trans.statement_id;
+        } else {
+            base.transformations.push_back(trans);
+        }
+    }
+    if (loop.empty()) return true;
+    
+    // Multi-statement configs vectorize a loop of the tagged statement
+    tiramisu::computation* target = &comp;
+    if (config.statements.size() >= 2) {
+        if (statement_id < 0 || statement_id >= (int)statement_comps_.size()) return false;
+        target = statement_comps_[statement_id];
+    }
+    
+    std::string key = "vec:" + verdict_scope(comp) + legality_key(base) + ":" +
+                      std::to_string(statement_id) + ":" + loop;
+    auto cached = config_verdicts_.find(key);
+    if (cached != config_verdicts_.end()) {
+        legality_stats_.cache_hits++;
+        return cached->second;
+    }
+    
+    bool legal = false;
+    std::string error;
+    reset_schedules();
+    if (apply_config_to_computation(comp, base, error)) {
+        std::string name = resolve_loop_name(*target, loop, true);
+        std::vector<std::string> levels = target->get_loop_level_names();
+        if (std::find(levels.begin(), levels.end(), name) != levels.end()) {
+            legality_stats_.isl_checks++;
+            tiramisu_func_->prepare_schedules_for_legality_checks(false);
+            legal = tiramisu_func_->loop_vectorization_is_legal(tiramisu::var(name), {target});
+        }
+    }
+    reset_schedules();
+    
+    config_verdicts_[key] = legal;
+    return legal;
+}
+
+bool TiramisuConfigEvaluator::parallelization_is_legal(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config
+) {
+    if (!tiramisu_func_) return true;
+    
+    // The schedule the parallel loops live in, without their tags
+    ScheduleConfig base = config;
+    std::vector<Transformation> tags;
+    base.transformations.clear();
+    for (const auto& trans : config.transformations) {
+        if (trans.type == TRANS_PARALLELIZE && trans.iterator_names.size() == 1) {
+            tags.push_back(trans);
+        } else {
+            base.transformations.push_back(trans);
+        }
+    }
+    if (tags.empty()) return true;
+    ScopedPhase phase(PHASE_LEGALITY);
+    prepare_dependences();
+    
+    std::string key = "par:" + verdict_scope(comp) + legality_key(config);
+    auto cached = config_verdicts_.find(key);
+    if (cached != config_verdicts_.end()) {
+        legality_stats_.cache_hits++;
+        return cached->second;
+    }
+    
+    bool legal = false;
+    std::string error;
+    reset_schedules();
+    if (apply_config_to_computation(comp, base, error)) {
+        // Statements sharing the loop are checked together
+        std::vector<tiramisu::computation*> fused = {&comp};
+        if (config.statements.size() >= 2) fused = statement_comps_;
+        
+        tiramisu_func_->prepare_schedules_for_legality_checks(false);
+        legal = true;
+        for (size_t t = 0; t < tags.size() && legal; t++) {
+            tiramisu::computation* target = &comp;
+            if (config.statements.size() >= 2) {
+                int s = tags[t].statement_id;
+                target = (s >= 0 && s < (int)statement_comps_.size()) ? statement_comps_[s] : nullptr;
+            }
+            legal = false;
+            if (!target) break;
+            std::string name = resolve_loop_name(*target, tags[t].iterator_names[0], false);
+            std::vector<std::string> levels = target->get_loop_level_names();
+            if (std::find(levels.begin(), levels.end(), name) == levels.end()) break;
+            
+            legality_stats_.isl_checks++;
+            legal = tiramisu_func_->loop_parallelization_is_legal(tiramisu::var(name), fused);
+        }
+    }
+    reset_schedules();
+    
+    config_verdicts_[key] = legal;
+    if (!legal) BridgeProfiler::instance().count("illegal_parallel_tags");
+    return legal;
+}
+
+std::string TiramisuConfigEvaluator::artifact_base() {
+    static int eval_counter = 0;
+    return work_dir_ + "/pgs_" + tiramisu_func_->get_name() + "_" +
+           std::to_string(getpid()) + "_" + std::to_string(eval_counter++);
+}
+
+std::string TiramisuConfigEvaluator::compile_to_shared_library(
+    std::string& error,
+    MeasurementResult* cost,
+    const std::string& base
+) {
+    const std::vector<tiramisu::buffer*>& args = tiramisu_func_->get_arguments();
+    if (args.empty()) {
+        error = "function has no arguments (call set_arguments / codegen first)";
+        return "";
+    }
+    
+    std::string prefix = base.empty() ? artifact_base() : base;
+    std::string obj_path = prefix + ".o";
+    std::string so_path = prefix + ".so";
+    auto start = std::chrono::steady_clock::now();
+    
+    {
+        ScopedPhase phase(PHASE_CODEGEN);
+        tiramisu_func_->codegen(args, obj_path);
+    }
+    
+    // Turn the object file to a shared library (same as Tiramisu's
+    // evaluate_by_execution)
+    std::string cmd = "g++ -shared -o " + so_path + " " + obj_path;
+    int status;
+    {
+        ScopedPhase phase(PHASE_COMPILE);
+        status = system(cmd.c_str());
+    }
+    std::remove(obj_path.c_str());
+    
+    if (status != 0) {
+        BridgeProfiler::instance().count("compile_failures");
+        error = "failed to link " + so_path;
+        return "";
+    }
+    
+    if (cost) {
+        cost->compile_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        struct stat st;
+        cost->code_size_bytes = stat(so_path.c_str(), &st) == 0 ? (int64_t)st.st_size : -1;
+    }
+    return so_path;
+}
+
+// Fill a buffer with small deterministic values (avoid NaN / denormals)
+static void fill_buffer(Halide::Buffer<>& buf) {
+    halide_buffer_t* raw = buf.raw_buffer();
+    size_t n = buf.number_of_elements();
+    halide_type_t t = raw->type;
+    
+    for (size_t e = 0; e < n; e++) {
+        int v = (int)(e % 7) + 1;
+        if (t.code == halide_type_float && t.bits == 32) {
+            ((float*)raw->host)[e] = v * 0.125f;
+        } else if (t.code == halide_type_float && t.bits == 64) {
+            ((double*)raw->host)[e] = v * 0.125;
+        } else {
+            // Integers: write the low byte, rest zero
+            size_t bytes = t.bytes();
+            std::memset(raw->host + e * bytes, 0, bytes);
+            raw->host[e * bytes] = (uint8_t)v;
+        }
+    }
+}
+
+// Scratch memory of a kernel run: the kernel's Halide runtime allocates its
+// heap temporaries through halide_malloc, which can be redirected here
+namespace {
+
+typedef void* (*halide_malloc_fn)(void*, size_t);
+typedef void (*halide_free_fn)(void*, void*);
+typedef halide_malloc_fn (*set_custom_malloc_fn)(halide_malloc_fn);
+typedef halide_free_fn (*set_custom_free_fn)(halide_free_fn);
+
+struct ScratchTracker {
+    std::mutex mutex;
+    std::map<void*, size_t> live;
+    int64_t bytes = 0;
+    int64_t peak = 0;
+};
+
+ScratchTracker& scratch_tracker() {
+    static ScratchTracker tracker;
+    return tracker;
+}
+
+void* tracking_malloc(void*, size_t size) {
+    // Halide expects buffers aligned like its own halide_malloc
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, 128, std::max<size_t>(size, 1)) != 0) return nullptr;
+    
+    ScratchTracker& t = scratch_tracker();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    t.live[ptr] = size;
+    t.bytes += size;
+    t.peak = std::max(t.peak, t.bytes);
+    return ptr;
+}
+
+void tracking_free(void*, void* ptr) {
+    if (!ptr) return;
+    {
+        ScratchTracker& t = scratch_tracker();
+        std::lock_guard<std::mutex> lock(t.mutex);
+        auto it = t.live.find(ptr);
+        if (it != t.live.end()) {
+            t.bytes -= it->second;
+            t.live.erase(it);
+        }
+    }
+    free(ptr);
+}
+
+// Installs the tracking allocator into the kernel's runtime (and the
+// process-wide one, in case the kernel's runtime symbols were interposed)
+// for its lifetime
+class ScratchHook {
+public:
+    explicit ScratchHook(void* handle) : installed_(false), baseline_(0) {
+        for (void* scope : {handle, RTLD_DEFAULT}) {
+            auto set_malloc = (set_custom_malloc_fn)dlsym(scope, "halide_set_custom_malloc");
+            auto set_free = (set_custom_free_fn)dlsym(scope, "halide_set_custom_free");
+            if (!set_malloc || !set_free) continue;
+            if (std::find(setters_.begin(), setters_.end(), (void*)set_malloc) != setters_.end()) continue;
+            
+            setters_.push_back((void*)set_malloc);
+            restore_.push_back(std::make_pair(set_malloc, set_free));
+            prev_.push_back(std::make_pair(set_malloc(tracking_malloc), set_free(tracking_free)));
+            installed_ = true;
+        }
+    }
+    ~ScratchHook() {
+        for (size_t i = 0; i < restore_.size(); i++) {
+            restore_[i].first(prev_[i].first);
+            restore_[i].second(prev_[i].second);
+        }
+    }
+    
+    bool installed() const { return installed_; }
+    
+    void reset_peak() {
+        ScratchTracker& t = scratch_tracker();
+        std::lock_guard<std::mutex> lock(t.mutex);
+        t.peak = t.bytes;
+        baseline_ = t.bytes;
+    }
+    int64_t peak() const {
+        ScratchTracker& t = scratch_tracker();
+        std::lock_guard<std::mutex> lock(t.mutex);
+        return t.peak - baseline_;
+    }
+
+private:
+    bool installed_;
+    int64_t baseline_;
+    std::vector<void*> setters_;
+    std::vector<std::pair<set_custom_malloc_fn, set_custom_free_fn>> restore_;
+    std::vector<std::pair<halide_malloc_fn, halide_free_fn>> prev_;
+};
+
+} // namespace
+
+MeasurementResult TiramisuConfigEvaluator::run_shared_library(
+    const std::string& so_path,
+    int num_runs
+) {
+    ScopedPhase phase(PHASE_RUN);
+    MeasurementResult result;
+    
+    void* handle = dlopen(so_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        result.error = std::string("dlopen failed: ") + dlerror();
+        return result;
+    }
+    
+    // Tiramisu lowers with ExternalPlusMetadata, so Halide emits an
+    // argv-style entry point next to the typed one
+    typedef int (*kernel_argv_fn)(void**);
+    std::string sym = tiramisu_func_->get_name() + "_argv";
+    kernel_argv_fn kernel = (kernel_argv_fn)dlsym(handle, sym.c_str());
+    if (!kernel) {
+        result.error = "symbol not found: " + sym;
+        dlclose(handle);
+        return result;
+    }
+    
+    // Allocate real buffers for every argument
+    std::vector<Halide::Buffer<>> buffers;
+    std::vector<void*> argv;
+    for (tiramisu::buffer* b : tiramisu_func_->get_arguments()) {
+        std::vector<int> sizes;
+        for (const tiramisu::expr& e : b->get_dim_sizes()) {
+            if (e.get_expr_type() == tiramisu::e_val) {
+                sizes.push_back((int)e.get_int_val());
+            } else if (e.get_expr_type() == tiramisu::e_var &&
+                       param_values_.count(e.get_name())) {
+                sizes.push_back((int)param_values_[e.get_name()]);
+            } else {
+                result.error = "unknown extent for buffer " + b->get_name() +
+                               " (use set_parameter_value)";
+                dlclose(handle);
+                return result;
+            }
+        }
+        // Halide dimensions are innermost-first
+        std::reverse(sizes.begin(), sizes.end());
+        
+        buffers.emplace_back(
+            tiramisu::halide_type_from_tiramisu_type(b->get_elements_type()),
+            sizes, b->get_name());
+        fill_buffer(buffers.back());
+    }
+    for (auto& buf : buffers) {
+        argv.push_back(buf.raw_buffer());
+    }
+    
+    bool failed = false;
+    {
+        // Peak scratch from one separate untimed run: the tracking allocator
+        // locks and updates a map per call, so it stays out of the timings
+        ScratchHook hook(handle);
+        hook.reset_peak();
+        failed = kernel(argv.data()) != 0;
+        result.peak_scratch_bytes = hook.installed() ? hook.peak() : -1;
+    }
+    
+    // Timed runs on the kernel's default allocator
+    for (int w = 0; w < num_warmup_runs_ && !failed; w++) {
+        failed = kernel(argv.data()) != 0;
+    }
+    for (int r = 0; r < num_runs && !failed; r++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        int status = kernel(argv.data());
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        failed = status != 0;
+        result.samples_ms.push_back(
+            std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    dlclose(handle);
+    
+    if (failed) {
+        result.error = "kernel returned an error";
+        result.samples_ms.clear();
+        return result;
+    }
+    BridgeProfiler::instance().count("kernel_runs", num_runs);
+    
+    summarize_samples(result);
+    result.ok = true;
+    return result;
+}
+
+// Median and distribution-free 95% CI of the median:
+// ranks n/2 ± 1.96·sqrt(n)/2 of the sorted samples
+void TiramisuConfigEvaluator::summarize_samples(MeasurementResult& result) {
+    if (result.samples_ms.empty()) return;
+    
+    std::vector<double> sorted = result.samples_ms;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    
+    result.median_ms = (n % 2 == 1) ? sorted[n / 2]
+                                    : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    
+    double half_width = 1.96 * std::sqrt((double)n) / 2.0;
+    long lo = (long)std::floor(n / 2.0 - half_width);
+    long hi = (long)std::ceil(n / 2.0 + half_width);
+    lo = std::max(0L, std::min(lo, (long)n - 1));
+    hi = std::max(0L, std::min(hi, (long)n - 1));
+    result.ci_low_ms = sorted[lo];
+    result.ci_high_ms = sorted[hi];
+    
+    // Tail: nearest-rank 99th percentile; spread: coefficient of variation
+    size_t p99 = (size_t)std::ceil(0.99 * n);
+    result.p99_ms = sorted[std::max<size_t>(p99, 1) - 1];
+    
+    double mean = 0.0, var = 0.0;
+    for (double t : sorted) mean += t;
+    mean /= n;
+    for (double t : sorted) var += (t - mean) * (t - mean);
+    var = n > 1 ? var / (n - 1) : 0.0;
+    result.cv = mean > 0 ? std::sqrt(var) / mean : 0.0;
+}
+
+// NEW:  
+double TiramisuConfigEvaluator::compute_penalized_score(
+    const ScheduleConfig& config, 
+    double raw_time
+) {
+    if (!config.has_bank_conflict) {
+        return raw_time;
+    }
+    
+    // conflict
+    double penalty_multiplier = 1.0;
+    
+    switch (config.bank_conflict_way) {
+        case 2:  // 2-way conflict
+            penalty_multiplier = bank_conflict_penalty_factor_;  // 2.0x
+            break;
+        case 4:  // 4-way conflict
+            penalty_multiplier = bank_conflict_penalty_factor_ * 1.5;  // 3.0x
+            break;
+        case 8:  // 8-way conflict
+            penalty_multiplier = bank_conflict_penalty_factor_ * 2.0;  // 4.0x
+            break;
+        case 16: // 16-way conflict
+            penalty_multiplier = bank_conflict_penalty_factor_ * 4.0;  // 8.0x
+            break;
+        case 32: // 32-way conflict ()
+            penalty_multiplier = bank_conflict_penalty_factor_ * 16.0; // 32.0x
+            break;
+        default:
+            if (config.bank_conflict_way > 1) {
+                // ：penalty ≈ conflict_way
+                penalty_multiplier = config.bank_conflict_way * 
+                                    (bank_conflict_penalty_factor_ / 2.0);
+            }
+    }
+    
+    return raw_time * penalty_multiplier;
+}
+
+bool TiramisuConfigEvaluator::satisfies_coalescing_constraint(
+    const ScheduleConfig& config
+) {
+    if (config.transformations.empty()) return false;
+    
+    const auto& innermost = config.transformations.back();
+    if (innermost.type == TRANS_GPU_TILE) {
+        return true;
+    }
+    
+    return true; // Simplified check
+}
+
+// Copy a measurement's distribution and code costs into the config
+// (execution_time_ms is set by the caller, possibly penalized)
+static void record_measurement(ScheduleConfig& config, const MeasurementResult& m) {
+    config.time_ci_low_ms = m.ci_low_ms;
+    config.time_ci_high_ms = m.ci_high_ms;
+    config.time_p99_ms = m.p99_ms;
+    config.time_cv = m.cv;
+    config.compile_time_ms = m.compile_ms;
+    config.code_size_bytes = m.code_size_bytes;
+    config.scratch_bytes = m.peak_scratch_bytes;
+}
+
+ScheduleConfig TiramisuConfigEvaluator::search_best_config(
+    tiramisu::computation& comp,
+    const std::vector<ScheduleConfig>& candidates,
+    std::vector<ScheduleConfig>* measured
+) {
+    if (racing_.enabled) {
+        return search_best_config_racing(comp, candidates, measured);
+    }
+    
+    ScheduleConfig best_config;
+    double best_time = std::numeric_limits<double>::max();
+    
+    bridge_log() << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    bridge_log() << "  Searching best config among " << candidates.size() 
+                 << " candidates (" << measurement_slots() << " measured at once)\n";
+    bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    
+    std::vector<ScheduleConfig> results = candidates;
+    measure_all_configs(comp, results);
+    
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& config = results[i];
+        double time = config.is_valid ? config.execution_time_ms : -1.0;
+        
+        bridge_log() << "[" << (i+1) << "/" << results.size() << "] "
+                     << config.description;
+        
+        // status
+        if (config.has_bank_conflict) {
+            bridge_log() << " [WARNING " << config.bank_conflict_way << "-way BC]";
+        }
+        if (config.has_coalescing_violation) {
+            bridge_log() << " [WARNING Non-coalesced]";
+        }
+        bridge_log() << ": ";
+        
+        if (time > 0 && measured) {
+            measured->push_back(config);
+        }
+        
+        if (time > 0 && time < best_time) {
+            best_time = time;
+            best_config = config;
+            bridge_log() << "Y " << time << " ms [" << config.time_ci_low_ms << ", "
+                         << config.time_ci_high_ms << "] (NEW BEST)\n";
+        } else if (time > 0) {
+            bridge_log() << "Y " << time << " ms [" << config.time_ci_low_ms << ", "
+                         << config.time_ci_high_ms << "]\n";
+        } else {
+            bridge_log() << "N Failed\n";
+        }
+    }
+    
+    bridge_log() << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    bridge_log() << "  Best: " << best_config.description 
+                 << " (" << best_time << " ms)\n";
+    bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    
+    return best_config;
+}
+
+ScheduleConfig TiramisuConfigEvaluator::search_best_config_racing(
+    tiramisu::computation& comp,
+    const std::vector<ScheduleConfig>& candidates,
+    std::vector<ScheduleConfig>* measured
+) {
+    struct Racer {
+        size_t index;
+        std::string so_path;
+        MeasurementResult m;
+        double score;  // penalized median
+        double low;    // penalized CI bounds
+        double high;
+    };
+    
+    // Racers leave the race with the samples they got so far
+    auto retire = [&](Racer& r) {
+        std::remove(r.so_path.c_str());
+        if (!measured || !r.m.ok) return;
+        measured->push_back(candidates[r.index]);
+        measured->back().execution_time_ms = r.score;
+        record_measurement(measured->back(), r.m);
+    };
+    
+    bridge_log() << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    bridge_log() << "  Racing " << candidates.size() << " candidates\n";
+    bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    
+    // Compile every candidate once; rounds only re-run the kernels
+    std::vector<Racer> racers;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        std::string error;
+        MeasurementResult cost;
+        reset_schedules();
+        std::string so_path;
+        if (apply_config_to_computation(comp, candidates[i], error)) {
+            so_path = compile_to_shared_library(error, &cost);
+        }
+        reset_schedules();
+        
+        if (so_path.empty()) {
+            bridge_log() << "N " << candidates[i].description << " (" << error << ")\n";
+            continue;
+        }
+        racers.push_back(Racer{i, so_path, cost, 0.0, 0.0, 0.0});
+    }
+    
+    int runs = std::max(1, racing_.initial_runs);
+    int total_runs = 0;
+    int round = 0;
+    
+    while (!racers.empty()) {
+        round++;
+        
+        // Give every survivor `runs` more runs
+        std::vector<Racer> alive;
+        for (auto& r : racers) {
+            MeasurementResult more = run_shared_library(r.so_path, runs);
+            total_runs += runs;
+            if (!more.ok) {
+                bridge_log() << "N " << candidates[r.index].description
+                             << " (" << more.error << ")\n";
+                std::remove(r.so_path.c_str());
+                continue;
+            }
+            r.m.samples_ms.insert(r.m.samples_ms.end(),
+                                  more.samples_ms.begin(), more.samples_ms.end());
+            summarize_samples(r.m);
+            r.m.ok = true;
+            r.m.peak_scratch_bytes = std::max(r.m.peak_scratch_bytes, more.peak_scratch_bytes);
+            
+            // Scores and bounds on the same (penalized) scale
+            r.score = r.m.median_ms;
+            r.low = r.m.ci_low_ms;
+            r.high = r.m.ci_high_ms;
+            if (apply_bank_conflict_penalty_ && candidates[r.index].has_bank_conflict) {
+                r.score = compute_penalized_score(candidates[r.index], r.score);
+                r.low = compute_penalized_score(candidates[r.index], r.low);
+                r.high = compute_penalized_score(candidates[r.index], r.high);
+            }
+            alive.push_back(r);
+        }
+        racers.swap(alive);
+        if (racers.size() <= 1) break;
+        
+        std::sort(racers.begin(), racers.end(),
+                  [](const Racer& a, const Racer& b) { return a.score < b.score; });
+        
+        // Too few samples for a CI to mean anything: nobody leaves yet
+        int samples = (int)racers[0].m.samples_ms.size();
+        if (samples < racing_.min_samples && samples < racing_.max_runs) {
+            bridge_log() << "Round " << round << ": " << runs << " run(s) each, "
+                         << racers.size() << " candidates (" << samples << "/"
+                         << racing_.min_samples << " samples before eliminating)\n";
+            runs = std::min(runs * 2, racing_.max_runs - samples);
+            continue;
+        }
+        
+        // Winner separated: its CI lies below every contender's CI
+        const Racer& leader = racers[0];
+        bool separated = true;
+        for (size_t i = 1; i < racers.size() && separated; i++) {
+            separated = leader.high < racers[i].low;
+        }
+        if (separated) {
+            bridge_log() << "Round " << round << ": winner separated\n";
+            for (size_t i = 1; i < racers.size(); i++) {
+                retire(racers[i]);
+            }
+            racers.resize(1);
+            break;
+        }
+        
+        // Drop the slow half and everything clearly behind the leader
+        size_t keep = std::max<size_t>(2, (racers.size() + 1) / 2);
+        std::vector<Racer> survivors;
+        for (size_t i = 0; i < racers.size(); i++) {
+            bool close = racers[i].low <= leader.high;
+            if (i == 0 || (i < keep && close)) {
+                survivors.push_back(racers[i]);
+            } else {
+                retire(racers[i]);
+            }
+        }
+        
+        bridge_log() << "Round " << round << ": " << runs << " run(s) each, "
+                     << racers.size() << " -> " << survivors.size() << " candidates\n";
+        racers.swap(survivors);
+        
+        if ((int)racers[0].m.samples_ms.size() >= racing_.max_runs) break;
+        runs = std::min(runs * 2, racing_.max_runs - (int)racers[0].m.samples_ms.size());
+    }
+    
+    ScheduleConfig best_config;
+    if (racers.empty()) {
+        bridge_log() << "N No candidate survived\n";
+        return best_config;
+    }
+    
+    std::sort(racers.begin(), racers.end(),
+              [](const Racer& a, const Racer& b) { return a.score < b.score; });
+    best_config = candidates[racers[0].index];
+    best_config.execution_time_ms = racers[0].score;
+    record_measurement(best_config, racers[0].m);
+    
+    for (auto& r : racers) {
+        retire(r);
+    }
+    
+    bridge_log() << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    bridge_log() << "  Best: " << best_config.description 
+                 << " (" << best_config.execution_time_ms << " ms, "
+                 << total_runs << " runs vs " << candidates.size() * racing_.max_runs
+                 << " without racing)\n";
+    bridge_log() << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    
+    return best_config;
+}
+
+// ----------------------------------------------------------------------------
+// Worker pool helpers
+// ----------------------------------------------------------------------------
+
+namespace {
+
+struct PoolWorker {
+    pid_t pid;
+    int fd;                 // Read end of the result pipe
+    size_t candidate;
+    bool measuring;         // false = compile worker
+    std::vector<int> cores; // Measurement cores held (measure workers)
+    std::string artifacts;  // <artifacts>.o / .so of a compile worker
+    std::chrono::steady_clock::time_point start;
+};
+
+// Pin the calling process to the given cores (Linux only)
+void pin_to_cores(const std::vector<int>& cores) {
+#ifdef __linux__
+    if (cores.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cores) {
+        CPU_SET(c, &set);
+    }
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cores;
+#endif
+}
+
+// Fork a worker; the child runs body, writes its result line and exits
+template <typename Body>
+bool spawn_worker(PoolWorker& worker, Body body) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    
+    bridge_log().flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    
+    if (pid == 0) {
+        close(fds[0]);
+        std::string line = body();
+        ssize_t written = write(fds[1], line.c_str(), line.size());
+        (void)written;
+        close(fds[1]);
+        _exit(0);
+    }
+    
+    close(fds[1]);
+    worker.pid = pid;
+    worker.fd = fds[0];
+    worker.start = std::chrono::steady_clock::now();
+    return true;
+}
+
+std::string read_all(int fd) {
+    std::string out;
+    char buf[512];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        out.append(buf, n);
+    }
+    return out;
+}
+
+} // namespace
+
+static bool has_parallel_loop(const ScheduleConfig& config) {
+    for (const auto& trans : config.transformations) {
+        if (trans.type == TRANS_PARALLELIZE) return true;
+    }
+    return false;
+}
+
+void TiramisuConfigEvaluator::pool_layout(int& num_compile, int& num_measure) const {
+    int num_cores = std::max(1u, std::thread::hardware_concurrency());
+    num_compile = pool_options_.num_compile_workers > 0
+                ? pool_options_.num_compile_workers
+                : std::max(1, num_cores / 4);
+    num_measure = pool_options_.num_measure_workers > 0
+                ? std::min(pool_options_.num_measure_workers, num_cores)
+                : std::max(1, num_cores - num_compile);
+}
+
+int TiramisuConfigEvaluator::measurement_slots() const {
+    if (!pool_options_.enabled) return 1;
+    int num_compile, num_measure;
+    pool_layout(num_compile, num_measure);
+    return num_measure;
+}
+
+void TiramisuConfigEvaluator::measure_all_configs(
+    tiramisu::computation& comp,
+    std::vector<ScheduleConfig>& candidates
+) {
+    if (pool_options_.enabled) {
+        run_worker_pool(comp, candidates);
+        return;
+    }
+    
+    for (auto& config : candidates) {
+        MeasurementResult m = measure_config(comp, config, pool_options_.num_runs);
+        BridgeProfiler::instance().count("candidates_measured");
+        config.is_valid = m.ok;
+        config.execution_time_ms = -1.0;
+        if (!m.ok) {
+            bridge_log() << "[Measure] " << config.description << " failed ("
+                         << m.error << ")\n";
+            continue;
+        }
+        config.execution_time_ms = m.median_ms;
+        if (apply_bank_conflict_penalty_ && config.has_bank_conflict) {
+            config.execution_time_ms = compute_penalized_score(config, m.median_ms);
+        }
+        record_measurement(config, m);
+    }
+}
+
+std::vector<ScheduleConfig> TiramisuConfigEvaluator::evaluate_all_configs(
+    tiramisu::computation& comp,
+    std::vector<ScheduleConfig> candidates
+) {
+    run_worker_pool(comp, candidates);
+    
+    // 
+    std::sort(candidates.begin(), candidates.end(),
+        [](const ScheduleConfig& a, const ScheduleConfig& b) {
+            if (!a.is_valid) return false;
+            if (!b.is_valid) return true;
+            return a.execution_time_ms < b.execution_time_ms;
+        });
+    
+    return candidates;
+}
+
+void TiramisuConfigEvaluator::run_worker_pool(
+    tiramisu::computation& comp,
+    std::vector<ScheduleConfig>& candidates
+) {
+    int num_cores = std::max(1u, std::thread::hardware_concurrency());
+    int num_compile, num_measure;
+    pool_layout(num_compile, num_measure);
+    
+    // Measurement workers own cores [0, num_measure); compile workers share the rest
+    std::vector<int> compile_cores;
+    for (int c = num_measure; c < num_cores; c++) {
+        compile_cores.push_back(c);
+    }
+    std::vector<bool> core_busy(num_measure, false);
+    
+    // Workers inherit the dependences instead of each recomputing them
+    prepare_dependences();
+    
+    std::vector<std::string> so_paths(candidates.size());
+    std::vector<size_t> measure_queue;
+    std::vector<PoolWorker> active;
+    size_t next_compile = 0;
+    int compiling = 0;
+    int measuring = 0;
+    
+    for (auto& config : candidates) {
+        config.execution_time_ms = -1.0;
+        config.is_valid = false;
+    }
+    BridgeProfiler::instance().count("candidates_measured", candidates.size());
+    
+    auto timeout = std::chrono::duration<double>(pool_options_.timeout_s);
+    
+    while (next_compile < candidates.size() || !measure_queue.empty() || !active.empty()) {
+        // Launch measurement workers on free dedicated cores; a parallel
+        // kernel is timed on all measurement cores, so it waits until no
+        // other measurement runs and holds them all (queue order is kept)
+        while (!measure_queue.empty()) {
+            size_t idx = measure_queue.front();
+            std::vector<int> cores;
+            if (has_parallel_loop(candidates[idx])) {
+                if (measuring > 0) break;
+                for (int core = 0; core < num_measure; core++) cores.push_back(core);
+            } else {
+                for (int core = 0; core < num_measure && cores.empty(); core++) {
+                    if (!core_busy[core]) cores.push_back(core);
+                }
+                if (cores.empty()) break;
+            }
+            measure_queue.erase(measure_queue.begin());
+            
+            PoolWorker w;
+            w.candidate = idx;
+            w.measuring = true;
+            w.cores = cores;
+            std::string so_path = so_paths[idx];
+            int runs = pool_options_.num_runs;
+            bool ok = spawn_worker(w, [&, so_path, runs, cores]() {
+                pin_to_cores(cores);
+                // The generated code's thread pool starts one thread per core
+                setenv("HL_NUM_THREADS", std::to_string(cores.size()).c_str(), 1);
+                MeasurementResult m = run_shared_library(so_path, runs);
+                if (!m.ok) return "ERR " + m.error + "\n";
+                return "OK " + std::to_string(m.median_ms) + " " +
+                       std::to_string(m.ci_low_ms) + " " +
+                       std::to_string(m.ci_high_ms) + " " +
+                       std::to_string(m.p99_ms) + " " +
+                       std::to_string(m.cv) + " " +
+                       std::to_string(m.peak_scratch_bytes) + "\n";
+            });
+            if (ok) {
+                for (int core : cores) core_busy[core] = true;
+                measuring++;
+                active.push_back(w);
+            } else {
+                std::remove(so_path.c_str());
+            }
+        }
+        
+        // Launch compile workers
+        while (compiling < num_compile && next_compile < candidates.size()) {
+            size_t idx = next_compile++;
+            
+            PoolWorker w;
+            w.candidate = idx;
+            w.measuring = false;
+            // Named by the parent, which cleans up after a killed worker
+            w.artifacts = artifact_base();
+            std::string artifacts = w.artifacts;
+            bool ok = spawn_worker(w, [&, idx, artifacts]() {
+                pin_to_cores(compile_cores);
+                std::string error;
+                MeasurementResult cost;
+                reset_schedules();
+                if (!apply_config_to_computation(comp, candidates[idx], error)) {
+                    return "ERR " + error + "\n";
+                }
+                std::string so_path = compile_to_shared_library(error, &cost, artifacts);
+                if (so_path.empty()) return "ERR " + error + "\n";
+                return "OK " + std::to_string(cost.compile_ms) + " " +
+                       std::to_string(cost.code_size_bytes) + " " + so_path + "\n";
+            });
+            if (ok) {
+                compiling++;
+                active.push_back(w);
+            }
+        }
+        
+        // Reap finished / hung workers
+        bool reaped = false;
+        for (size_t a = 0; a < active.size(); ) {
+            PoolWorker& w = active[a];
+            int status = 0;
+            pid_t done = waitpid(w.pid, &status, WNOHANG);
+            bool expired = std::chrono::steady_clock::now() - w.start > timeout;
+            
+            if (done == 0 && !expired) {
+                a++;
+                continue;
+            }
+            
+            std::string line;
+            if (done == 0) {
+                kill(w.pid, SIGKILL);
+                waitpid(w.pid, &status, 0);
+                BridgeProfiler::instance().count("worker_timeouts");
+                bridge_log() << "[Pool] Candidate " << w.candidate << " timed out\n";
+            } else {
+                line = read_all(w.fd);
+            }
+            close(w.fd);
+            
+            // Workers are forked, so their own timers are lost: charge the
+            // worker's wall time to its phase here
+            BridgeProfiler::instance().record(w.measuring ? PHASE_RUN : PHASE_COMPILE,
+                                              w.start, std::chrono::steady_clock::now());
+            
+            bool success = WIFEXITED(status) && line.compare(0, 3, "OK ") == 0;
+            ScheduleConfig& config = candidates[w.candidate];
+            
+            if (line.compare(0, 4, "ERR ") == 0) {
+                bridge_log() << "[Pool] Candidate " << w.candidate << " failed: "
+                             << line.substr(4);
+            }
+            
+            if (w.measuring) {
+                for (int core : w.cores) core_busy[core] = false;
+                measuring--;
+                std::remove(so_paths[w.candidate].c_str());
+                
+                double median = -1.0, lo = -1.0, hi = -1.0, p99 = -1.0, cv = -1.0;
+                long long scratch = -1;
+                if (success &&
+                    sscanf(line.c_str() + 3, "%lf %lf %lf %lf %lf %lld",
+                           &median, &lo, &hi, &p99, &cv, &scratch) == 6) {
+                    config.execution_time_ms = median;
+                    if (apply_bank_conflict_penalty_ && config.has_bank_conflict) {
+                        config.execution_time_ms = compute_penalized_score(config, median);
+                    }
+                    config.time_ci_low_ms = lo;
+                    config.time_ci_high_ms = hi;
+                    config.time_p99_ms = p99;
+                    config.time_cv = cv;
+                    config.scratch_bytes = scratch;
+                    config.is_valid = true;
+                } else if (WIFSIGNALED(status)) {
+                    bridge_log() << "[Pool] Candidate " << w.candidate
+                                 << " crashed (signal " << WTERMSIG(status) << ")\n";
+                }
+            } else {
+                compiling--;
+                double compile_ms = -1.0;
+                long long code_size = -1;
+                int path_start = 0;
+                if (success &&
+                    sscanf(line.c_str() + 3, "%lf %lld %n", &compile_ms, &code_size,
+                           &path_start) == 2 && path_start > 0) {
+                    std::string path = line.substr(3 + path_start);
+                    path.erase(path.find_last_not_of("\n") + 1);
+                    so_paths[w.candidate] = path;
+                    config.compile_time_ms = compile_ms;
+                    config.code_size_bytes = code_size;
+                    measure_queue.push_back(w.candidate);
+                } else {
+                    // A killed or crashed worker leaves its partial artifacts
+                    std::remove((w.artifacts + ".o").c_str());
+                    std::remove((w.artifacts + ".so").c_str());
+                    if (WIFSIGNALED(status)) {
+                        bridge_log() << "[Pool] Candidate " << w.candidate
+                                     << " crashed during codegen (signal "
+                                     << WTERMSIG(status) << ")\n";
+                    }
+                }
+            }
+            
+            active.erase(active.begin() + a);
+            reaped = true;
+        }
+        
+        if (!reaped) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+bool TiramisuConfigEvaluator::config_is_lowerable(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config,
+    std::string& error
+) {
+    // Tiramisu reports unknown loops with ERROR(), which exits the process:
+    // every loop a transformation names must exist before lowering starts
+    struct Nest {
+        int statement_id;
+        tiramisu::computation* comp;
+        const std::vector<std::string>* loop_order;
+    };
+    std::vector<Nest> nests;
+    if (config.statements.size() < 2) {
+        nests.push_back({0, &comp, nullptr});
+    } else {
+        // The function's computations also hold its inputs, so statements
+        // are only mapped through set_statement_computations
+        if (statement_comps_.empty()) {
+            error = "multi-statement config without set_statement_computations";
+            return false;
+        }
+        for (const auto& sched : config.statements) {
+            if (sched.statement_id < 0 || (size_t)sched.statement_id >= statement_comps_.size()) {
+                error = "no computation for statement S" + std::to_string(sched.statement_id);
+                return false;
+            }
+            nests.push_back({sched.statement_id, statement_comps_[sched.statement_id],
+                             &sched.loop_order});
+        }
+    }
+    
+    for (const auto& nest : nests) {
+        std::vector<std::string> levels = nest.comp->get_loop_level_names();
+        std::set<std::string> known(levels.begin(), levels.end());
+        
+        // PLUTO orders loops by hyperplane; a non-exact schedule names its
+        // levels t<l>, which no Tiramisu loop is called
+        if (nest.loop_order) {
+            for (const auto& name : *nest.loop_order) {
+                if (!known.count(name)) {
+                    error = "loop order of S" + std::to_string(nest.statement_id) +
+                            " names " + name + ", which is not a loop of " +
+                            nest.comp->get_name();
+                    bridge_log() << "WARNING  " << error << "; config rejected\n";
+                    return false;
+                }
+            }
+        }
+        
+        for (const auto& trans : config.transformations) {
+            if (trans.statement_id != nest.statement_id || trans.type != TRANS_DIAMOND_TILE) continue;
+            if (trans.hyperplanes.size() != levels.size() ||
+                trans.iterator_names.size() != levels.size()) {
+                error = "diamond tile of " + std::to_string(trans.hyperplanes.size()) +
+                        " hyperplanes on a " + std::to_string(levels.size()) + "-deep nest";
+                return false;
+            }
+            for (const auto& name : diamond_loop_names(trans)) known.insert(name);
+        }
+        
+        for (const auto& trans : config.transformations) {
+            if (trans.statement_id != nest.statement_id) continue;
+            for (const auto& name : trans.iterator_names) {
+                if (!known.count(name)) {
+                    error = "unknown loop " + name + " in " + nest.comp->get_name();
+                    return false;
+                }
+            }
+            if (trans.iterator_names.empty()) {
+                for (int dim : trans.loop_dims) {
+                    if (dim < 0 || (size_t)dim >= levels.size()) {
+                        error = "loop dimension " + std::to_string(dim) + " out of range in " +
+                                nest.comp->get_name();
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool TiramisuConfigEvaluator::apply_config_to_computation(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config,
+    std::string& error
+) {
+    if (!config_is_lowerable(comp, config, error)) {
+        BridgeProfiler::instance().count("unlowerable_candidates");
+        return false;
+    }
+    
+    if (config.statements.size() < 2) {
+        if (!apply_nest_schedule(comp, config, 0, {}, error)) {
+            BridgeProfiler::instance().count("unlowerable_candidates");
+            return false;
+        }
+        return true;
+    }
+    
+    // One computation per statement, ordered with after() at the depth
+    // of the loops PLUTO fused them under
+    const std::vector<tiramisu::computation*>& comps = statement_comps_;
+    
+    tiramisu::computation* prev = nullptr;
+    const StatementSchedule* prev_sched = nullptr;
+    
+    for (const auto& sched : config.statements) {
+        tiramisu::computation* cur = comps[sched.statement_id];
+        if (!apply_nest_schedule(*cur, config, sched.statement_id, sched.loop_order, error)) {
+            BridgeProfiler::instance().count("unlowerable_candidates");
+            return false;
+        }
+        
+        if (prev) {
+            int level = tiramisu::computation::root_dimension;
+            int fused = std::min<int>(sched.fused_loops, prev_sched->loop_order.size());
+            if (fused > 0) {
+                std::string name = resolve_loop_name(
+                    *prev, prev_sched->loop_order[fused - 1], false);
+                std::vector<std::string> levels = prev->get_loop_level_names();
+                auto it = std::find(levels.begin(), levels.end(), name);
+                if (it != levels.end()) {
+                    level = it - levels.begin();
+                }
+            }
+            cur->after(*prev, level);
+        }
+        
+        prev = cur;
+        prev_sched = &sched;
+    }
+    return true;
+}
+
+bool TiramisuConfigEvaluator::apply_nest_schedule(
+    tiramisu::computation& comp,
+    const ScheduleConfig& config,
+    int statement_id,
+    const std::vector<std::string>& default_loop_order,
+    std::string& error
+) {
+    // Lowering order: skew / reversal -> loop order -> tile -> unroll-and-jam
+    // -> parallelize -> unroll -> vectorize
+    // Later stages look loops up by original iterator name
+    // (resolve_loop_name), so every stage works on any loop depth
+    std::vector<Transformation> skews, swaps, tiles, splits, jams, parallel, unrolls, vectors, diamonds;
+    std::vector<std::string> loop_order;
+    
+    for (const auto& trans : config.transformations) {
+        if (trans.statement_id != statement_id) continue;
+        
+        switch (trans.type) {
+            case TRANS_SKEW:
+            case TRANS_REVERSE: skews.push_back(trans); break;
+            case TRANS_INTERCHANGE:
+                // One iterator per entry = loop order (outer -> inner)
+                if (trans.iterator_names.size() == 1) {
+                    loop_order.push_back(trans.iterator_names[0]);
+                } else {
+                    swaps.push_back(trans);
+                }
+                break;
+            case TRANS_TILE:
+            case TRANS_GPU_TILE: tiles.push_back(trans); break;
+            case TRANS_SPLIT: splits.push_back(trans); break;
+            case TRANS_PARALLELIZE: parallel.push_back(trans); break;
+            case TRANS_UNROLL: unrolls.push_back(trans); break;
+            case TRANS_VECTORIZE: vectors.push_back(trans); break;
+            case TRANS_DIAMOND_TILE: diamonds.push_back(trans); break;
+            case TRANS_UNROLL_JAM: jams.push_back(trans); break;
+        }
+    }
+    
+    // A diamond tile is the whole band schedule: it replaces skews, loop
+    // order, tiling and parallelization; unroll / vectorize still apply
+    if (!diamonds.empty()) {
+        converter_.apply_transformations(comp, diamonds);
+        converter_.apply_transformations(comp, unrolls);
+        converter_.apply_transformations(comp, vectors);
+        return true;
+    }
+    
+    if (loop_order.empty()) {
+        loop_order = default_loop_order;
+    }
+    
+    converter_.apply_transformations(comp, skews);
+    converter_.apply_transformations(comp, swaps);
+    
+    if (loop_order.size() >= 2) {
+        std::vector<std::string> levels = comp.get_loop_level_names();
+        std::vector<std::string> current;
+        for (const auto& name : loop_order) {
+            std::string level = resolve_loop_name(comp, name, false);
+            if (std::find(levels.begin(), levels.end(), level) != levels.end()) {
+                current.push_back(level);
+            }
+        }
+        // config_is_lowerable rejects orders with unknown loops up front
+        if (current.size() == loop_order.size()) {
+            converter_.apply_loop_order(comp, current);
+        } else {
+            bridge_log() << "WARNING  Loop order of " << comp.get_name()
+                         << " names unknown loops, not applied\n";
+        }
+    }
+    
+    // Explicit tile_sizes override the tile transformations of the config;
+    // the band is taken in the (new) loop order. Outer levels come first,
+    // each further level tiles the point loops of the previous one.
+    if (!config.tile_sizes.empty()) {
+        std::vector<std::vector<ScheduleConfig::TileSize>> levels = config.outer_tile_sizes;
+        levels.push_back(config.tile_sizes);
+        for (const auto& sizes : levels) {
+            Transformation tile(TRANS_TILE);
+            for (const auto& level : comp.get_loop_level_names()) {
+                for (const auto& ts : sizes) {
+                    if (ts.size > 0 && resolve_loop_name(comp, ts.loop_name, true) == level) {
+                        tile.iterator_names.push_back(ts.loop_name);
+                        tile.tile_sizes.push_back(ts.size);
+                    }
+                }
+            }
+            if (!tile.tile_sizes.empty()) {
+                converter_.apply_transformations(comp, {tile});
+            }
+        }
+    } else {
+        // CPU lowering of the tile transformations (GPU tiles are tiled on CPU)
+        for (auto& trans : tiles) {
+            trans.type = TRANS_TILE;
+        }
+        converter_.apply_transformations(comp, tiles);
+    }
+    
+    converter_.apply_transformations(comp, splits);
+    
+    // Register tile on the point loops; explicit factors override the
+    // unroll-and-jam transformations of the config
+    if (!config.unroll_jam.empty()) {
+        Transformation jam(TRANS_UNROLL_JAM);
+        for (const auto& ts : config.unroll_jam) {
+            jam.iterator_names.push_back(ts.loop_name);
+            jam.tile_sizes.push_back(ts.size);
+        }
+        jams = {jam};
+    }
+    
+    // The converter only warns when the jammed loops are not adjacent point
+    // loops around an inner loop: reject such configs instead of timing an
+    // untransformed nest under a "+uj" label
+    std::vector<std::string> jam_loops, enclosed;
+    for (const auto& jam : jams) {
+        if (!unroll_jam_is_applicable(comp, jam, jam_loops, error)) {
+            error += " (" + comp.get_name() + ")";
+            return false;
+        }
+        std::vector<std::string> levels = comp.get_loop_level_names();
+        auto last = std::find(levels.begin(), levels.end(), jam_loops.back());
+        enclosed.assign(last + 1, levels.end());
+        converter_.apply_transformations(comp, {jam});
+    }
+    converter_.apply_transformations(comp, parallel);
+    converter_.apply_transformations(comp, unrolls);
+    
+    // vectorize() splits its loop in place: the jammed copies stay the
+    // point loops around it only if it is one of the loops the jam encloses
+    for (const auto& vec : vectors) {
+        if (jams.empty() || vec.iterator_names.empty()) continue;
+        std::string name = resolve_loop_name(comp, vec.iterator_names[0], true);
+        if (std::find(enclosed.begin(), enclosed.end(), name) == enclosed.end()) {
+            error = "vector loop " + name + " of " + comp.get_name() +
+                    " is not inside its unroll-and-jam";
+            return false;
+        }
+    }
+    converter_.apply_transformations(comp, vectors);
+    return true;
+}
+
+// ============================================================================
+// VectorISA Implementation
+// ============================================================================
+
+const VectorISA& VectorISA::detect() {
+    static const VectorISA cached = []() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return VectorISA("avx512", 64, 32);
+        if (__builtin_cpu_supports("avx2")) return VectorISA("avx2", 32);
+        if (__builtin_cpu_supports("avx")) return VectorISA("avx", 32);
+        if (__builtin_cpu_supports("sse2")) return VectorISA("sse2", 16);
+        return VectorISA();
+#elif defined(__ARM_NEON)
+        return VectorISA("neon", 16, 32);
+#else
+        return VectorISA();
+#endif
+    }();
+    return cached;
+}
+
+// ============================================================================
+// RooflineModel Implementation
+// ============================================================================
+
+// Nominal clock of core 0 in GHz (cpufreq maximum, else /proc/cpuinfo),
+// 0 if unknown
+static double nominal_clock_ghz() {
+    double ghz = 0.0;
+    if (FILE* f = fopen("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", "r")) {
+        long khz = 0;
+        if (fscanf(f, "%ld", &khz) == 1) ghz = khz / 1e6;
+        fclose(f);
+    }
+    if (ghz <= 0.0) {
+        if (FILE* f = fopen("/proc/cpuinfo", "r")) {
+            char line[256];
+            double mhz = 0.0;
+            while (fgets(line, sizeof(line), f)) {
+                if (sscanf(line, "cpu MHz : %lf", &mhz) == 1) {
+                    ghz = mhz / 1e3;
+                    break;
+                }
+            }
+            fclose(f);
+        }
+    }
+    return ghz;
+}
+
+const MachinePeaks& MachinePeaks::measure() {
+    static const MachinePeaks cached = []() {
+        MachinePeaks peaks;
+        peaks.num_cores = std::max(1u, std::thread::hardware_concurrency());
+        
+        peaks.capacity_bytes = cache_capacities();
+        
+        // Compute peak, checked against what the ISA allows: far below it,
+        // the probe (not the machine) is the bottleneck
+        peaks.peak_gflops = probe_peak_gflops();
+        const VectorISA& isa = VectorISA::detect();
+        peaks.nominal_gflops = nominal_clock_ghz() * std::max(1, isa.lanes(sizeof(double))) * 2 * 2;
+        if (peaks.nominal_gflops > 0) {
+            double share = peaks.peak_gflops / peaks.nominal_gflops;
+            bridge_log() << "[Roofline] Compute probe: " << peaks.peak_gflops << " GFLOP/s, "
+                         << (int)(share * 100) << "% of the nominal " << isa.name << " peak ("
+                         << peaks.nominal_gflops << " GFLOP/s)\n";
+            if (share < 0.25) {
+                bridge_log() << "WARNING  Compute probe far below the nominal peak; "
+                             << "compute bounds will be pessimistic\n";
+            }
+        }
+        
+        // Read bandwidth: half of each cache level, 4x L3 for DRAM
+        std::vector<int64_t> working_sets;
+        for (int64_t cap : peaks.capacity_bytes) working_sets.push_back(cap / 2);
+        working_sets.push_back(peaks.capacity_bytes.back() * 4);
+        
+        for (int64_t bytes : working_sets) {
+            peaks.bandwidth_gbs.push_back(probe_read_bandwidth_gbs(bytes));
+        }
+        
+        return peaks;
+    }();
+    return cached;
+}
+
+const MachinePeaks& RooflineModel::machine_peaks() {
+    if (!has_peaks_) {
+        peaks_ = MachinePeaks::measure();
+        has_peaks_ = true;
+    }
+    return peaks_;
+}
+
+int64_t RooflineModel::trip_count(
+    const std::string& loop,
+    const std::vector<AccessPattern>& patterns
+) const {
+    auto it = loop_extents_.find(loop);
+    if (it != loop_extents_.end()) return it->second;
+    return array_extent_of_loop(loop, patterns);
+}
+
+RooflinePrediction RooflineModel::predict(
+    const ScheduleConfig& config,
+    const std::vector<AccessPattern>& patterns
+) {
+    const MachinePeaks& peaks = machine_peaks();
+    
+    RooflinePrediction pred;
+    pred.candidate_index = 0;
+    
+    // Loops of the nest and their tile sizes (untiled = whole loop)
+    std::vector<std::string> loops;
+    for (const auto& pattern : patterns) {
+        const auto& names = pattern.has_affine_access() ? pattern.iterator_names
+                                                        : pattern.indices;
+        for (const auto& name : names) {
+            if (!name.empty() && std::find(loops.begin(), loops.end(), name) == loops.end()) {
+                loops.push_back(name);
+            }
+        }
+    }
+    
+    // Loops of unknown extent (no set_loop_extent / set_array_extents) are
+    // modelled at a nominal trip count
+    const int64_t nominal_trip = 1024;
+    std::map<std::string, int64_t> trip;
+    double iterations = 1.0;
+    for (const auto& loop : loops) {
+        int64_t count = trip_count(loop, patterns);
+        trip[loop] = count > 0 ? count : nominal_trip;
+        iterations *= trip[loop];
+    }
+    
+    // Footprint and count of the tiles of every level, innermost
+    // (tile_sizes) first; untiled loops span the whole loop
+    std::vector<std::vector<ScheduleConfig::TileSize>> tile_levels = {config.tile_sizes};
+    tile_levels.insert(tile_levels.end(), config.outer_tile_sizes.rbegin(),
+                       config.outer_tile_sizes.rend());
+    std::vector<double> footprints, tile_counts;
+    for (const auto& sizes : tile_levels) {
+        std::map<std::string, int64_t> tile;
+        double num_tiles = 1.0;
+        for (const auto& loop : loops) {
+            tile[loop] = trip[loop];
+            for (const auto& ts : sizes) {
+                if (ts.loop_name == loop && ts.size > 0) {
+                    tile[loop] = std::min<int64_t>(ts.size, trip[loop]);
+                }
+            }
+            num_tiles *= std::ceil((double)trip[loop] / tile[loop]);
+        }
+        footprints.push_back(tile_footprint_bytes(tile, patterns));
+        tile_counts.push_back(num_tiles);
+    }
+    
+    // Compulsory traffic of every array
+    double compulsory = 0.0;
+    double streaming = 0.0;  // Bytes per iteration without any tile reuse
+    const double line_bytes = 64.0;
+    for (const auto& pattern : patterns) {
+        size_t ndims = pattern.has_affine_access() ? pattern.coeffs.size()
+                                                   : pattern.indices.size();
+        double array_elems = 1.0;
+        for (size_t r = 0; r < ndims; r++) {
+            int64_t extent = pattern.extent(r);
+            array_elems *= extent > 0 ? extent : nominal_trip;
+        }
+        compulsory += array_elems * pattern.element_size;
+        
+        int64_t stride = solver_ ? solver_->compute_stride_for_pattern(config, pattern) : 1;
+        if (stride == 1) {
+            streaming += pattern.element_size;
+        } else if (stride != 0) {
+            streaming += line_bytes;
+        }
+    }
+    
+    // Parallel loops scale compute and private-cache bandwidth with cores
+    bool parallel = false;
+    for (const auto& trans : config.transformations) {
+        if (trans.type == TRANS_PARALLELIZE) parallel = true;
+    }
+    double cores = parallel ? peaks.num_cores : 1.0;
+    
+    pred.flops = iterations * flops_per_iteration_;
+    pred.compute_ms = pred.flops / (peaks.peak_gflops * cores * 1e9) * 1e3;
+    pred.predicted_ms = pred.compute_ms;
+    pred.bound = "compute";
+    
+    // L1 -> register loads: accesses invariant in the innermost loop stay
+    // in registers; a register tile of C jammed copies loads each other
+    // access once per copy it varies in, i.e. copies / C per iteration
+    double jammed = 1.0;
+    for (const auto& ts : config.unroll_jam) jammed *= std::max(1, ts.size);
+    double register_bytes = 0.0;
+    for (const auto& pattern : patterns) {
+        if (solver_ && solver_->compute_stride_for_pattern(config, pattern) == 0) continue;
+        double copies = 1.0;
+        for (const auto& ts : config.unroll_jam) {
+            if (ts.size > 1 && access_uses_loop(pattern, ts.loop_name)) copies *= ts.size;
+        }
+        register_bytes += pattern.element_size * copies / jammed;
+    }
+    pred.register_ms = 0.0;
+    if (!peaks.bandwidth_gbs.empty() && peaks.bandwidth_gbs[0] > 0) {
+        pred.register_ms = iterations * register_bytes /
+                           (peaks.bandwidth_gbs[0] * cores * 1e9) * 1e3;
+    }
+    if (pred.register_ms > pred.predicted_ms) {
+        pred.predicted_ms = pred.register_ms;
+        pred.bound = "L1";
+    }
+    
+    // Traffic into level l comes from level l+1 (L2, L3, DRAM)
+    static const char* suppliers[] = {"L2", "L3", "DRAM"};
+    for (size_t l = 0; l < peaks.capacity_bytes.size(); l++) {
+        // Each tile of a level that fits is loaded once; the cheapest such
+        // level wins, no reuse at all if none fits
+        double bytes = -1.0;
+        for (size_t t = 0; t < footprints.size(); t++) {
+            double tiled = tile_counts[t] * footprints[t];
+            if (footprints[t] <= peaks.capacity_bytes[l] && (bytes < 0 || tiled < bytes)) {
+                bytes = tiled;
+            }
+        }
+        if (bytes < 0) bytes = iterations * streaming;
+        bytes = std::max(bytes, compulsory);
+        
+        // Set conflicts evict L1 lines before reuse
+        if (l == 0 && config.has_bank_conflict) {
+            bytes *= config.bank_conflict_way;
+        }
+        
+        double bandwidth = l + 1 < peaks.bandwidth_gbs.size() ? peaks.bandwidth_gbs[l + 1] : 1.0;
+        if (l < 2) bandwidth *= cores;  // Private L2 / L1 paths
+        double ms = bytes / (bandwidth * 1e9) * 1e3;
+        
+        pred.bytes_per_level.push_back(bytes);
+        pred.memory_ms.push_back(ms);
+        if (ms > pred.predicted_ms) {
+            pred.predicted_ms = ms;
+            pred.bound = suppliers[std::min<size_t>(l, 2)];
+        }
+    }
+    
+    return pred;
+}
+
+std::vector<RooflinePrediction> RooflineModel::rank(
+    std::vector<ScheduleConfig>& candidates,
+    const std::vector<AccessPattern>& patterns
+) {
+    std::vector<RooflinePrediction> predictions;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        RooflinePrediction pred = predict(candidates[i], patterns);
+        pred.candidate_index = i;
+        candidates[i].predicted_time_ms = pred.predicted_ms;
+        predictions.push_back(pred);
+    }
+    
+    std::stable_sort(predictions.begin(), predictions.end(),
+        [](const RooflinePrediction& a, const RooflinePrediction& b) {
+            return a.predicted_ms < b.predicted_ms;
+        });
+    
+    return predictions;
+}
+
+// ============================================================================
+// Selection Policy
+// ============================================================================
+
+const char* schedule_objective_name(ScheduleObjective objective) {
+    switch (objective) {
+        case OBJ_TIME: return "time";
+        case OBJ_P99_TIME: return "p99_time";
+        case OBJ_CODE_SIZE: return "code_size";
+        case OBJ_COMPILE_TIME: return "compile_time";
+        case OBJ_SCRATCH: return "scratch";
+        case OBJ_VARIANCE: return "variance";
+        default: return "unknown";
+    }
+}
+
+double schedule_objective_value(const ScheduleConfig& config, ScheduleObjective objective) {
+    const double unknown = std::numeric_limits<double>::infinity();
+    switch (objective) {
+        case OBJ_TIME:
+            return config.execution_time_ms > 0 ? config.execution_time_ms : unknown;
+        case OBJ_P99_TIME:
+            return config.time_p99_ms > 0 ? config.time_p99_ms : unknown;
+        case OBJ_CODE_SIZE:
+            return config.code_size_bytes >= 0 ? (double)config.code_size_bytes : unknown;
+        case OBJ_COMPILE_TIME:
+            return config.compile_time_ms >= 0 ? config.compile_time_ms : unknown;
+        case OBJ_SCRATCH:
+            return config.scratch_bytes >= 0 ? (double)config.scratch_bytes : unknown;
+        case OBJ_VARIANCE:
+            return config.time_cv >= 0 ? config.time_cv : unknown;
+        default:
+            return unknown;
+    }
+}
+
+// a dominates b: no worse on every objective, better on at least one
+static bool dominates(const ScheduleConfig& a, const ScheduleConfig& b) {
+    bool better = false;
+    for (int o = 0; o < NUM_SCHEDULE_OBJECTIVES; o++) {
+        double va = schedule_objective_value(a, (ScheduleObjective)o);
+        double vb = schedule_objective_value(b, (ScheduleObjective)o);
+        if (va > vb) return false;
+        if (va < vb) better = true;
+    }
+    return better;
+}
+
+std::vector<ScheduleConfig> pareto_front(const std::vector<ScheduleConfig>& measured) {
+    std::vector<ScheduleConfig> front;
+    for (size_t i = 0; i < measured.size(); i++) {
+        if (measured[i].execution_time_ms <= 0) continue;
+        bool dominated = false;
+        for (size_t j = 0; j < measured.size() && !dominated; j++) {
+            dominated = j != i && measured[j].execution_time_ms > 0 &&
+                        dominates(measured[j], measured[i]);
         }
+        if (!dominated) front.push_back(measured[i]);
     }
     
-    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    std::sort(front.begin(), front.end(),
+              [](const ScheduleConfig& a, const ScheduleConfig& b) {
+                  return a.execution_time_ms < b.execution_time_ms;
+              });
+    return front;
+}
+
+ScheduleConfig select_by_policy(const std::vector<ScheduleConfig>& measured,
+                                const SelectionPolicy& policy) {
+    const double unknown = std::numeric_limits<double>::infinity();
+    double best_primary = unknown;
+    for (const auto& config : measured) {
+        best_primary = std::min(best_primary, schedule_objective_value(config, policy.primary));
+    }
+    if (best_primary == unknown) return ScheduleConfig();
+    
+    // Acceptable band on the primary objective, then the secondary decides
+    // (ties broken by the primary)
+    double limit = best_primary * (1.0 + std::max(0.0, policy.tolerance));
+    const ScheduleConfig* chosen = nullptr;
+    for (const auto& config : measured) {
+        double primary = schedule_objective_value(config, policy.primary);
+        if (primary > limit) continue;
+        if (!chosen) {
+            chosen = &config;
+            continue;
+        }
+        double secondary = schedule_objective_value(config, policy.secondary);
+        double chosen_secondary = schedule_objective_value(*chosen, policy.secondary);
+        if (secondary < chosen_secondary ||
+            (secondary == chosen_secondary &&
+             primary < schedule_objective_value(*chosen, policy.primary))) {
+            chosen = &config;
+        }
+    }
+    return *chosen;
 }
 
 // ============================================================================
-// TiramisuConfigEvaluator Implementation
+// HybridOptimizer Implementation
 // ============================================================================
 
-double TiramisuConfigEvaluator::evaluate_config(
+HybridOptimizer::OptimizationResult HybridOptimizer::optimize(
     tiramisu::computation& comp,
-    const ScheduleConfig& config,
-    int num_runs
+    PlutoProg* base_prog,
+    const std::string& strategy
 ) {
-    // Approach1: （）
-    // versionrequires，
-    
-    double estimated_time = 100.0; // (ms)
-    
-    // tile size
-    if (!config.tile_sizes.empty()) {
-        int avg_tile = 0;
-        for (const auto& ts : config.tile_sizes) {
-            avg_tile += ts.size;
-        }
-        avg_tile /= config.tile_sizes.size();
+    // Tuning cache: same SCoP on the same machine under the same selection
+    // policy -> reuse the selected config
+    uint64_t scop_hash = 0;
+    if (tuning_db_ && tuning_db_->is_open()) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        scop_hash = TuningDatabase::hash_scop(base_prog, param_values_);
         
-        // tile sizeat32-64
-        if (avg_tile >= 32 && avg_tile <= 64) {
-            estimated_time *= 0.8;  // 20% faster
-        } else if (avg_tile < 16) {
-            estimated_time *= 1.3;  // 30% slower (too small)
-        } else if (avg_tile > 128) {
-            estimated_time *= 1.2;  // 20% slower (too large)
+        TuningRecord record;
+        if (tuning_db_->lookup(scop_hash, record, policy_)) {
+            OptimizationResult result;
+            result.best_config = record.config;
+            result.all_candidates.push_back(record.config);
+            result.num_candidates_generated = 0;
+            result.num_legal_candidates = 0;
+            result.num_evaluated = 0;
+            result.best_time_ms = record.execution_time_ms;
+            result.worst_time_ms = record.execution_time_ms;
+            result.average_time_ms = record.execution_time_ms;
+            result.from_cache = true;
+            
+            auto end_time = std::chrono::high_resolution_clock::now();
+            result.total_search_time_ms =
+                std::chrono::duration<double, std::milli>(end_time - start_time).count();
+            
+            bridge_log() << "Cache: Tuning database hit (" << record.config.description
+                         << ", " << record.execution_time_ms << " ms)\n";
+            return result;
         }
     }
     
-    // coalescing
-    if (satisfies_coalescing_constraint(config)) {
-        estimated_time *= 0.7;  // 30% faster with coalescing
-    }
-    
-    // （ ）
-    double noise = (rand() % 20 - 10) / 100.0; // ±10%
-    estimated_time *= (1.0 + noise);
+    OptimizationResult result = run_strategy(comp, base_prog, strategy);
     
-    // NEW: bank conflict
-    if (apply_bank_conflict_penalty_ && config.has_bank_conflict) {
-        estimated_time = compute_penalized_score(config, estimated_time);
+    if (tuning_db_ && tuning_db_->is_open() &&
+        result.best_config.execution_time_ms > 0) {
+        tuning_db_->store(scop_hash, result.best_config,
+                          result.best_config.execution_time_ms, policy_);
     }
     
-    return estimated_time;
-    
-    /* Approach2: （requiresMultiImplementation）
-    try {
-        // computation
-        apply_config_to_computation(comp, config);
-        
-        // 
-        tiramisu_func_->codegen({}, "temp_eval.o");
-        
-        // 
-        // system("g++ temp_eval.o -o temp_eval");
-        // auto start = std::chrono::high_resolution_clock::now();
-        // system("./temp_eval");
-        // auto end = std::chrono::high_resolution_clock::now();
-        // return duration_ms;
-        
-        return 1.0;
-    } catch (...) {
-        return -1.0; // 
-    }
-    */
+    return result;
 }
 
-// NEW:  
-double TiramisuConfigEvaluator::compute_penalized_score(
-    const ScheduleConfig& config, 
-    double raw_time
+std::vector<RooflinePrediction> HybridOptimizer::rank_candidates(
+    std::vector<ScheduleConfig>& candidates
 ) {
-    if (!config.has_bank_conflict) {
-        return raw_time;
+    return model_.rank(candidates, solver_.get_access_patterns());
+}
+
+std::vector<ScheduleConfig> HybridOptimizer::preselect_by_model(
+    std::vector<ScheduleConfig>& candidates,
+    OptimizationResult& result
+) {
+    result.predictions = rank_candidates(candidates);
+    if (model_top_k_ == 0 || candidates.size() <= model_top_k_) {
+        return candidates;
     }
     
-    // conflict
-    double penalty_multiplier = 1.0;
-    
-    switch (config.bank_conflict_way) {
-        case 2:  // 2-way conflict
-            penalty_multiplier = bank_conflict_penalty_factor_;  // 2.0x
-            break;
-        case 4:  // 4-way conflict
-            penalty_multiplier = bank_conflict_penalty_factor_ * 1.5;  // 3.0x
-            break;
-        case 8:  // 8-way conflict
-            penalty_multiplier = bank_conflict_penalty_factor_ * 2.0;  // 4.0x
-            break;
-        case 16: // 16-way conflict
-            penalty_multiplier = bank_conflict_penalty_factor_ * 4.0;  // 8.0x
-            break;
-        case 32: // 32-way conflict ()
-            penalty_multiplier = bank_conflict_penalty_factor_ * 16.0; // 32.0x
-            break;
-        default:
-            if (config.bank_conflict_way > 1) {
-                // ：penalty ≈ conflict_way
-                penalty_multiplier = config.bank_conflict_way * 
-                                    (bank_conflict_penalty_factor_ / 2.0);
-            }
+    std::vector<ScheduleConfig> selected;
+    for (size_t i = 0; i < model_top_k_; i++) {
+        selected.push_back(candidates[result.predictions[i].candidate_index]);
     }
     
-    return raw_time * penalty_multiplier;
+    bridge_log() << "Model: Roofline kept " << selected.size() << " of "
+                 << candidates.size() << " candidates for measurement\n";
+    return selected;
 }
 
-bool TiramisuConfigEvaluator::satisfies_coalescing_constraint(
-    const ScheduleConfig& config
+std::vector<ScheduleConfig> HybridOptimizer::filter_legal(
+    tiramisu::computation& comp,
+    const std::vector<ScheduleConfig>& candidates
 ) {
-    if (config.transformations.empty()) return false;
-    
-    const auto& innermost = config.transformations.back();
-    if (innermost.type == TRANS_GPU_TILE) {
-        return true;
+    std::vector<ScheduleConfig> legal;
+    for (const auto& config : candidates) {
+        if (solver_.is_legal_config(config) && evaluator_.check_legality(comp, config) &&
+            evaluator_.parallelization_is_legal(comp, config)) {
+            legal.push_back(config);
+            add_vectorization(comp, legal.back());
+        }
     }
     
-    return true; // Simplified check
+    const TiramisuConfigEvaluator::LegalityStats& stats = evaluator_.legality_stats();
+    bridge_log() << "Legality: " << legal.size() << " of " << candidates.size()
+                 << " candidates legal (" << stats.isl_checks << " isl checks, "
+                 << stats.prefix_rejections << " prefix rejections so far)\n";
+    return legal;
 }
 
-ScheduleConfig TiramisuConfigEvaluator::search_best_config(
+void HybridOptimizer::add_vectorization(
     tiramisu::computation& comp,
-    const std::vector<ScheduleConfig>& candidates
+    ScheduleConfig& config
 ) {
-    ScheduleConfig best_config;
-    double best_time = std::numeric_limits<double>::max();
-    
-    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-    std::cout << "  Searching best config among " << candidates.size() 
-              << " candidates\n";
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+    if (!auto_vectorize_) return;
+    for (const auto& trans : config.transformations) {
+        if (trans.type == TRANS_VECTORIZE) return;
+    }
     
-    for (size_t i = 0; i < candidates.size(); i++) {
-        const auto& config = candidates[i];
+    if (config.statements.size() < 2) {
+        Transformation vectorize(TRANS_VECTORIZE);
+        if (!solver_.select_vectorization(config, isa_, vectorize)) return;
         
-        std::cout << "[" << (i+1) << "/" << candidates.size() << "] "
-                  << "Evaluating: " << config.description;
+        ScheduleConfig vectorized = config;
+        vectorized.transformations.push_back(vectorize);
+        if (!evaluator_.vectorization_is_legal(comp, vectorized)) return;
         
-        // status
-        if (config.has_bank_conflict) {
-            std::cout << " [WARNING " << config.bank_conflict_way << "-way BC]";
+        vectorized.description += " +vec(" + vectorize.iterator_names[0] + "," +
+                                  std::to_string(vectorize.factor) + "," + isa_.name + ")";
+        config = vectorized;
+        BridgeProfiler::instance().count("vectorized_candidates");
+        return;
+    }
+    
+    // Multi-statement: each statement's innermost loop, selected on a
+    // single-nest view of that statement (its loop order and steps)
+    std::vector<Transformation> vectors;
+    std::string label;
+    for (const auto& st : config.statements) {
+        if (st.loop_order.empty()) continue;
+        
+        ScheduleConfig nest;
+        nest.tile_sizes = config.tile_sizes;
+        for (const auto& trans : config.transformations) {
+            if (trans.statement_id != st.statement_id || trans.type == TRANS_INTERCHANGE) continue;
+            nest.transformations.push_back(trans);
+            nest.transformations.back().statement_id = 0;
         }
-        if (config.has_coalescing_violation) {
-            std::cout << " [WARNING Non-coalesced]";
+        for (const auto& name : st.loop_order) {
+            Transformation order(TRANS_INTERCHANGE);
+            order.iterator_names.push_back(name);
+            nest.transformations.push_back(order);
         }
-        std::cout << "... ";
         
-        double time = evaluate_config(comp, config, 10);
+        Transformation vectorize(TRANS_VECTORIZE);
+        if (!solver_.select_vectorization(nest, isa_, vectorize)) continue;
+        vectorize.statement_id = st.statement_id;
         
-        if (time > 0 && time < best_time) {
-            best_time = time;
-            best_config = config;
-            best_config.execution_time_ms = time;
-            std::cout << "Y " << time << " ms (NEW BEST)\n";
-        } else if (time > 0) {
-            std::cout << "Y " << time << " ms\n";
-        } else {
-            std::cout << "N Failed\n";
-        }
+        ScheduleConfig probe = config;
+        probe.transformations.push_back(vectorize);
+        if (!evaluator_.vectorization_is_legal(comp, probe)) continue;
+        
+        vectors.push_back(vectorize);
+        label += (label.empty() ? "" : ";") + std::string("S") +
+                 std::to_string(st.statement_id) + ":" + vectorize.iterator_names[0] +
+                 "," + std::to_string(vectorize.factor);
     }
+    if (vectors.empty()) return;
     
-    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-    std::cout << "  Best: " << best_config.description 
-              << " (" << best_time << " ms)\n";
-    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
-    
-    return best_config;
+    config.transformations.insert(config.transformations.end(), vectors.begin(), vectors.end());
+    config.description += " +vec(" + label + "," + isa_.name + ")";
+    BridgeProfiler::instance().count("vectorized_candidates");
 }
 
-std::vector<ScheduleConfig> TiramisuConfigEvaluator::evaluate_all_configs(
-    tiramisu::computation& comp,
-    std::vector<ScheduleConfig> candidates
+void HybridOptimizer::add_register_tiles(
+    std::vector<ScheduleConfig>& candidates,
+    size_t per_config
 ) {
-    for (auto& config : candidates) {
-        config.execution_time_ms = evaluate_config(comp, config, 10);
-        config.is_valid = (config.execution_time_ms > 0);
-    }
+    if (!register_tiles_) return;
     
-    // 
-    std::sort(candidates.begin(), candidates.end(),
-        [](const ScheduleConfig& a, const ScheduleConfig& b) {
-            if (!a.is_valid) return false;
-            if (!b.is_valid) return true;
-            return a.execution_time_ms < b.execution_time_ms;
-        });
-    
-    return candidates;
+    size_t num_base = candidates.size();
+    for (size_t c = 0; c < num_base; c++) {
+        if (!candidates[c].unroll_jam.empty()) continue;
+        for (const auto& jam : solver_.unroll_jam_variants(candidates[c], isa_, per_config)) {
+            ScheduleConfig variant = candidates[c];
+            variant.unroll_jam = jam;
+            variant.description += " +uj(";
+            for (size_t l = 0; l < jam.size(); l++) {
+                variant.description += (l ? "," : "") + jam[l].loop_name +
+                                       std::to_string(jam[l].size);
+            }
+            variant.description += ")";
+            candidates.push_back(variant);
+        }
+    }
+    BridgeProfiler::instance().count("register_tile_candidates", candidates.size() - num_base);
 }
 
-void TiramisuConfigEvaluator::apply_config_to_computation(
-    tiramisu::computation& comp,
-    const ScheduleConfig& config
+void HybridOptimizer::select_from_measured(
+    const std::vector<ScheduleConfig>& measured,
+    OptimizationResult& result
 ) {
-    // transformations
-    // TODO: ScheduleConfigTiramisu API
-    // ：comp.tile(), comp.gpu_tile(), comp.interchange()
+    result.pareto_front = pareto_front(measured);
+    
+    // Every policy's choice is on the frontier, unless a metric is missing
+    // for some candidates; select among all measured to stay exact
+    ScheduleConfig chosen = select_by_policy(measured, policy_);
+    if (chosen.execution_time_ms > 0) {
+        result.best_config = chosen;
+    }
+    
+    bridge_log() << "Pareto: " << result.pareto_front.size() << " of " << measured.size()
+                 << " measured candidates non-dominated; selected "
+                 << result.best_config.description << "\n";
 }
 
-// ============================================================================
-// HybridOptimizer Implementation
-// ============================================================================
-
-HybridOptimizer::OptimizationResult HybridOptimizer::optimize(
+HybridOptimizer::OptimizationResult HybridOptimizer::run_strategy(
     tiramisu::computation& comp,
     PlutoProg* base_prog,
     const std::string& strategy
@@ -730,9 +4386,18 @@ HybridOptimizer::OptimizationResult HybridOptimizer::optimize(
         for (int i = 0; i < ndims; i++) {
             names.push_back(base_prog->stmts[0]->iterators[i]);
         }
-        return optimize_with_all_legal(comp, ndims, names);
+        return optimize_with_all_legal(comp, base_prog, names);
     } else if (strategy == "sampling") {
         return optimize_with_sampling(comp, base_prog, 5);
+    } else if (strategy == "stencil") {
+        return optimize_stencil(comp, base_prog);
+    } else if (strategy == "bayesian") {
+        int ndims = base_prog->nvar;
+        std::vector<std::string> names;
+        for (int i = 0; i < ndims; i++) {
+            names.push_back(base_prog->stmts[0]->iterators[i]);
+        }
+        return optimize_with_bayesian(comp, base_prog, names, budget_);
     }
     
     // 
@@ -749,24 +4414,23 @@ HybridOptimizer::OptimizationResult HybridOptimizer::optimize_with_neighbors(
     OptimizationResult result;
     
     // 1. PLUTOGenerate
-    std::cout << "\nSearch: Step 1: PLUTO generates candidates...\n";
+    bridge_log() << "\nSearch: Step 1: PLUTO generates candidates...\n";
     result.all_candidates = solver_.generate_candidates_from_optimal(
         optimal_prog, num_neighbors);
+    add_register_tiles(result.all_candidates, 2);
     result.num_candidates_generated = result.all_candidates.size();
     
     // 
-    std::vector<ScheduleConfig> legal_candidates;
-    for (const auto& config : result.all_candidates) {
-        if (solver_.is_legal_config(config)) {
-            legal_candidates.push_back(config);
-        }
-    }
+    std::vector<ScheduleConfig> legal_candidates = filter_legal(comp, result.all_candidates);
     result.num_legal_candidates = legal_candidates.size();
+    std::vector<ScheduleConfig> selected = preselect_by_model(legal_candidates, result);
     
     // 2. Tiramisu
-    std::cout << "\nEval: Step 2: Tiramisu evaluates candidates...\n";
-    result.best_config = evaluator_.search_best_config(comp, legal_candidates);
-    result.num_evaluated = legal_candidates.size();
+    bridge_log() << "\nEval: Step 2: Tiramisu evaluates candidates...\n";
+    std::vector<ScheduleConfig> measured;
+    result.best_config = evaluator_.search_best_config(comp, selected, &measured);
+    select_from_measured(measured, result);
+    result.num_evaluated = selected.size();
     
     auto end_time = std::chrono::high_resolution_clock::now();
     result.total_search_time_ms = 
@@ -777,7 +4441,7 @@ HybridOptimizer::OptimizationResult HybridOptimizer::optimize_with_neighbors(
     result.worst_time_ms = 0;
     result.average_time_ms = 0;
     double sum = 0;
-    for (const auto& config : legal_candidates) {
+    for (const auto& config : selected) {
         if (config.execution_time_ms > 0) {
             sum += config.execution_time_ms;
             result.worst_time_ms = std::max(result.worst_time_ms, 
@@ -791,8 +4455,9 @@ HybridOptimizer::OptimizationResult HybridOptimizer::optimize_with_neighbors(
 
 HybridOptimizer::OptimizationResult HybridOptimizer::optimize_with_all_legal(
     tiramisu::computation& comp,
-    int num_loops,
-    const std::vector<std::string>& loop_names
+    PlutoProg* base_prog,
+    const std::vector<std::string>& loop_names,
+    size_t max_configs
 ) {
     auto start_time = std::chrono::high_resolution_clock::now();
     
@@ -800,13 +4465,17 @@ HybridOptimizer::OptimizationResult HybridOptimizer::optimize_with_all_legal(
     
     // PLUTOGeneratehas
     result.all_candidates = solver_.generate_all_legal_configs(
-        num_loops, loop_names, true);
+        base_prog, loop_names, true, max_configs);
     result.num_candidates_generated = result.all_candidates.size();
-    result.num_legal_candidates = result.all_candidates.size();
+    std::vector<ScheduleConfig> legal_candidates = filter_legal(comp, result.all_candidates);
+    result.num_legal_candidates = legal_candidates.size();
+    std::vector<ScheduleConfig> selected = preselect_by_model(legal_candidates, result);
     
     // Tiramisu
-    result.best_config = evaluator_.search_best_config(comp, result.all_candidates);
-    result.num_evaluated = result.all_candidates.size();
+    std::vector<ScheduleConfig> measured;
+    result.best_config = evaluator_.search_best_config(comp, selected, &measured);
+    select_from_measured(measured, result);
+    result.num_evaluated = selected.size();
     
     auto end_time = std::chrono::high_resolution_clock::now();
     result.total_search_time_ms = 
@@ -827,12 +4496,58 @@ HybridOptimizer::OptimizationResult HybridOptimizer::optimize_with_sampling(
     // PLUTO
     result.all_candidates = solver_.generate_by_constraint_sampling(
         base_prog, num_samples);
+    add_register_tiles(result.all_candidates, 2);
     result.num_candidates_generated = result.all_candidates.size();
-    result.num_legal_candidates = result.all_candidates.size();
+    std::vector<ScheduleConfig> legal_candidates = filter_legal(comp, result.all_candidates);
+    result.num_legal_candidates = legal_candidates.size();
+    std::vector<ScheduleConfig> selected = preselect_by_model(legal_candidates, result);
     
     // Tiramisu
-    result.best_config = evaluator_.search_best_config(comp, result.all_candidates);
-    result.num_evaluated = result.all_candidates.size();
+    std::vector<ScheduleConfig> measured;
+    result.best_config = evaluator_.search_best_config(comp, selected, &measured);
+    select_from_measured(measured, result);
+    result.num_evaluated = selected.size();
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.total_search_time_ms = 
+        std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    
+    return result;
+}
+
+HybridOptimizer::OptimizationResult HybridOptimizer::optimize_stencil(
+    tiramisu::computation& comp,
+    PlutoProg* base_prog
+) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    OptimizationResult result;
+    
+    // Concurrent-start and full diamonds, deduplicated by schedule and tile size
+    std::set<std::string> seen;
+    for (bool full : {false, true}) {
+        for (auto& config : solver_.generate_diamond_tiled(base_prog, full)) {
+            std::string key = schedule_signature(config) + "T" +
+                              std::to_string(config.transformations[0].tile_sizes[0]);
+            if (seen.insert(key).second) {
+                result.all_candidates.push_back(config);
+            }
+        }
+    }
+    if (result.all_candidates.empty()) {
+        bridge_log() << "Search: no diamond tiling for this program, using neighbors\n";
+        return optimize_with_neighbors(comp, base_prog, 10);
+    }
+    result.num_candidates_generated = result.all_candidates.size();
+    
+    std::vector<ScheduleConfig> legal_candidates = filter_legal(comp, result.all_candidates);
+    result.num_legal_candidates = legal_candidates.size();
+    std::vector<ScheduleConfig> selected = preselect_by_model(legal_candidates, result);
+    
+    std::vector<ScheduleConfig> measured;
+    result.best_config = evaluator_.search_best_config(comp, selected, &measured);
+    select_from_measured(measured, result);
+    result.num_evaluated = selected.size();
     
     auto end_time = std::chrono::high_resolution_clock::now();
     result.total_search_time_ms = 
@@ -841,4 +4556,277 @@ HybridOptimizer::OptimizationResult HybridOptimizer::optimize_with_sampling(
     return result;
 }
 
+// Surrogate features: normalized position of every loop in the loop order,
+// then log2 of its tile size (0 = untiled), then log2 of its unroll-and-jam
+// factor (0 = not jammed)
+static std::vector<double> config_features(
+    const ScheduleConfig& config,
+    const std::vector<std::string>& loop_names
+) {
+    std::vector<double> features;
+    
+    for (const auto& name : loop_names) {
+        double pos = 0.0;
+        int depth = 0;
+        for (const auto& trans : config.transformations) {
+            if (trans.type != TRANS_INTERCHANGE || trans.iterator_names.size() != 1) continue;
+            if (trans.iterator_names[0] == name) pos = depth;
+            depth++;
+        }
+        features.push_back(depth > 1 ? pos / (depth - 1) : 0.0);
+    }
+    for (const auto& name : loop_names) {
+        double log_tile = 0.0;
+        for (const auto& ts : config.tile_sizes) {
+            if (ts.loop_name == name && ts.size > 1) log_tile = std::log2((double)ts.size);
+        }
+        features.push_back(log_tile);
+    }
+    for (const auto& name : loop_names) {
+        double log_jam = 0.0;
+        for (const auto& ts : config.unroll_jam) {
+            if (ts.loop_name == name && ts.size > 1) log_jam = std::log2((double)ts.size);
+        }
+        features.push_back(log_jam);
+    }
+    
+    return features;
+}
+
+HybridOptimizer::OptimizationResult HybridOptimizer::optimize_with_bayesian(
+    tiramisu::computation& comp,
+    PlutoProg* base_prog,
+    const std::vector<std::string>& loop_names,
+    const SearchBudget& budget
+) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto elapsed_s = [&]() {
+        return std::chrono::duration<double>(
+            std::chrono::high_resolution_clock::now() - start_time).count();
+    };
+    
+    OptimizationResult result;
+    std::mt19937_64 rng(0x5eed);
+    
+    // 1. Candidate pool: legal loop orders x per-loop tile sizes
+    //    (tile size model's choice included per loop, non powers of two too)
+    std::vector<ScheduleConfig> orders;
+    LegalConfigEnumerator enumerator = solver_.enumerate_legal_configs(
+        base_prog, loop_names, {1}, true);
+    ScheduleConfig order;
+    while (enumerator.next(order)) {
+        orders.push_back(order);
+    }
+    
+    std::vector<std::vector<int>> tile_choices(loop_names.size(),
+        std::vector<int>{8, 16, 24, 32, 48, 64, 96, 128, 192, 256});
+    for (const auto& ts : solver_.model_tile_sizes(base_prog)) {
+        for (size_t l = 0; l < loop_names.size(); l++) {
+            auto& choices = tile_choices[l];
+            if (ts.loop_name == loop_names[l] &&
+                std::find(choices.begin(), choices.end(), ts.size) == choices.end()) {
+                choices.push_back(ts.size);
+            }
+        }
+    }
+    
+    double combos = 1.0;
+    for (const auto& choices : tile_choices) combos *= choices.size();
+    size_t per_order = orders.empty() ? 0
+                     : std::max<size_t>(1, budget.pool_size / orders.size());
+    
+    std::vector<ScheduleConfig> pool;
+    std::set<std::string> seen;
+    for (const auto& base : orders) {
+        size_t attempts = 0;
+        for (size_t n = 0; n < per_order && n < combos && attempts < 4 * per_order; attempts++) {
+            ScheduleConfig config = base;
+            std::string tiles;
+            for (size_t l = 0; l < loop_names.size(); l++) {
+                const auto& choices = tile_choices[l];
+                config.tile_sizes[l].size = choices[rng() % choices.size()];
+                tiles += (l ? "x" : "") + std::to_string(config.tile_sizes[l].size);
+            }
+            config.description = config.description.substr(0, config.description.find(", tile"))
+                               + ", tile " + tiles;
+            
+            // Register tile: none or one of the solver's unroll-and-jam variants
+            if (register_tiles_) {
+                std::vector<std::vector<ScheduleConfig::TileSize>> jams =
+                    solver_.unroll_jam_variants(config, isa_, 4);
+                size_t pick = rng() % (jams.size() + 1);
+                if (pick < jams.size()) {
+                    config.unroll_jam = jams[pick];
+                    config.description += ", jam ";
+                    for (size_t l = 0; l < jams[pick].size(); l++) {
+                        config.description += (l ? "x" : "") + jams[pick][l].loop_name +
+                                              std::to_string(jams[pick][l].size);
+                    }
+                }
+            }
+            if (seen.insert(config.description).second) {
+                pool.push_back(config);
+                n++;
+            }
+        }
+    }
+    result.num_candidates_generated = pool.size();
+    result.num_legal_candidates = pool.size();
+    
+    bridge_log() << "\nSearch: Bayesian optimization over " << pool.size()
+                 << " legal candidates (" << orders.size() << " loop orders)\n";
+    
+    // 2. Measure until the budget is spent
+    std::vector<std::vector<double>> features;
+    for (const auto& config : pool) {
+        features.push_back(config_features(config, loop_names));
+    }
+    
+    std::vector<bool> measured(pool.size(), false);
+    std::vector<std::vector<double>> X;          // Successful measurements
+    std::vector<double> y;                       // log(ms)
+    std::vector<size_t> failed;                  // Pool indices that failed
+    double best_log = std::numeric_limits<double>::max();
+    double worst_log = std::numeric_limits<double>::lowest();
+    RandomForestSurrogate surrogate;
+    
+    // Initial design: model's favourites first, then random
+    std::vector<size_t> initial;
+    if (!pool.empty()) {
+        std::vector<RooflinePrediction> ranking = model_.rank(pool, solver_.get_access_patterns());
+        for (size_t i = 0; i < ranking.size() && (int)initial.size() < budget.initial_samples / 2; i++) {
+            initial.push_back(ranking[i].candidate_index);
+        }
+        while ((int)initial.size() < budget.initial_samples && initial.size() < pool.size()) {
+            size_t idx = rng() % pool.size();
+            if (std::find(initial.begin(), initial.end(), idx) == initial.end()) {
+                initial.push_back(idx);
+            }
+        }
+    }
+    
+    // Candidates are measured in batches, one per measurement worker: the
+    // batch is the top of the ranking below (no refit inside a batch)
+    size_t batch_size = std::max(1, evaluator_.measurement_slots());
+    int num_measured = 0;
+    size_t num_initial = 0;
+    while (num_measured < (int)pool.size()) {
+        if (budget.max_measurements > 0 && num_measured >= budget.max_measurements) break;
+        if (budget.max_seconds > 0 && elapsed_s() >= budget.max_seconds) break;
+        
+        size_t room = batch_size;
+        if (budget.max_measurements > 0) {
+            room = std::min(room, (size_t)(budget.max_measurements - num_measured));
+        }
+        
+        // Next candidates: initial design, then expected improvement
+        // (random while nothing has been measured successfully yet)
+        std::vector<size_t> ranked;
+        if (num_initial < initial.size()) {
+            ranked.assign(initial.begin() + num_initial, initial.end());
+        } else if (X.empty()) {
+            for (size_t i = 0; i < pool.size(); i++) {
+                if (!measured[i]) ranked.push_back(i);
+            }
+            std::shuffle(ranked.begin(), ranked.end(), rng);
+        } else {
+            // Failures count as twice the slowest success; imputed only now
+            // that a success gives the scale
+            std::vector<std::vector<double>> fit_X = X;
+            std::vector<double> fit_y = y;
+            for (size_t f : failed) {
+                fit_X.push_back(features[f]);
+                fit_y.push_back(worst_log + std::log(2.0));
+            }
+            surrogate.fit(fit_X, fit_y);
+            std::vector<std::pair<double, size_t>> by_ei;
+            for (size_t i = 0; i < pool.size(); i++) {
+                if (measured[i]) continue;
+                double mean, stddev;
+                surrogate.predict(features[i], mean, stddev);
+                by_ei.push_back({-RandomForestSurrogate::expected_improvement(mean, stddev, best_log), i});
+            }
+            std::sort(by_ei.begin(), by_ei.end());
+            for (const auto& entry : by_ei) ranked.push_back(entry.second);
+        }
+        
+        // Illegal candidates leave the pool without using the budget
+        // (the enumerator's parallel tags are verified as in filter_legal)
+        std::vector<size_t> batch;
+        for (size_t r = 0; r < ranked.size() && batch.size() < room; r++) {
+            size_t next = ranked[r];
+            if (num_initial < initial.size()) num_initial++;
+            measured[next] = true;
+            if (!solver_.is_legal_config(pool[next]) || !evaluator_.check_legality(comp, pool[next]) ||
+                !evaluator_.parallelization_is_legal(comp, pool[next])) {
+                pool[next].is_valid = false;
+                continue;
+            }
+            add_vectorization(comp, pool[next]);
+            batch.push_back(next);
+        }
+        if (batch.empty()) {
+            if (ranked.empty()) break;
+            continue;
+        }
+        
+        std::vector<ScheduleConfig> configs;
+        for (size_t idx : batch) configs.push_back(pool[idx]);
+        evaluator_.measure_all_configs(comp, configs);
+        
+        for (size_t b = 0; b < batch.size(); b++) {
+            size_t next = batch[b];
+            ScheduleConfig& config = pool[next];
+            config = configs[b];
+            num_measured++;
+            bridge_log() << "[" << num_measured << "] " << config.description << ": ";
+            
+            if (config.is_valid && config.execution_time_ms > 0) {
+                double log_ms = std::log(config.execution_time_ms);
+                worst_log = std::max(worst_log, log_ms);
+                bridge_log() << "Y " << config.execution_time_ms << " ms\n";
+                
+                X.push_back(features[next]);
+                y.push_back(log_ms);
+                if (log_ms < best_log) {
+                    best_log = log_ms;
+                    result.best_config = config;
+                }
+            } else {
+                failed.push_back(next);
+                bridge_log() << "N Failed\n";
+            }
+            result.all_candidates.push_back(config);
+        }
+    }
+    
+    result.num_evaluated = num_measured;
+    result.total_search_time_ms = elapsed_s() * 1e3;
+    
+    std::vector<ScheduleConfig> measured_configs;
+    for (const auto& config : result.all_candidates) {
+        if (config.is_valid && config.execution_time_ms > 0) measured_configs.push_back(config);
+    }
+    select_from_measured(measured_configs, result);
+    
+    result.best_time_ms = result.best_config.execution_time_ms;
+    result.worst_time_ms = 0;
+    double sum = 0;
+    int ok = 0;
+    for (const auto& config : result.all_candidates) {
+        if (config.execution_time_ms > 0) {
+            sum += config.execution_time_ms;
+            ok++;
+            result.worst_time_ms = std::max(result.worst_time_ms, config.execution_time_ms);
+        }
+    }
+    result.average_time_ms = ok ? sum / ok : 0;
+    
+    bridge_log() << "Best: " << result.best_config.description << " ("
+                 << result.best_time_ms << " ms) after " << num_measured
+                 << " measurements\n";
+    
+    return result;
+}
+
 } // namespace pluto_tiramisu
@@ -3,7 +3,10 @@
 
 #include <vector>
 #include <string>
+#include <map>
 #include <functional>
+#include <memory>
+#include <algorithm>
 #include "pluto_to_tiramisu.h"
 
 namespace pluto_tiramisu {
@@ -12,10 +15,24 @@ namespace pluto_tiramisu {
 // Schedule Configuration Structure
 // ============================================================================
 
+// Schedule of one statement, extracted from its stmt->trans
+struct StatementSchedule {
+    int statement_id;                     // Index into prog->stmts
+    std::vector<std::string> loop_order;  // Loop hyperplanes, outer -> inner
+    std::vector<int64_t> scalar_dims;     // Scalar (fusion / distribution) hyperplanes
+    int fused_loops;                      // Loops shared with the previous statement
+    
+    StatementSchedule() : statement_id(0), fused_loops(0) {}
+};
+
 struct ScheduleConfig {
     // Transformation information
+    // (Transformation::statement_id selects the statement it applies to)
     std::vector<Transformation> transformations;
     
+    // Per-statement schedules in execution order (empty: single loop nest)
+    std::vector<StatementSchedule> statements;
+    
     // Tiling parameters
     struct TileSize {
         std::string loop_name;
@@ -23,13 +40,32 @@ struct ScheduleConfig {
     };
     std::vector<TileSize> tile_sizes;
     
+    // Outer tile levels for the cache hierarchy, outermost first (L3, L2);
+    // tile_sizes is the innermost (L1 / register) level and each outer
+    // size is a multiple of the size of the level inside it
+    std::vector<std::vector<TileSize>> outer_tile_sizes;
+    
+    // Register tile: unroll-and-jam factor (size) per loop, outer first;
+    // lowered inside the innermost tile level
+    std::vector<TileSize> unroll_jam;
+    
     // Evaluation results
-    double execution_time_ms;  // Evaluated by Tiramisu
+    double execution_time_ms;  // Evaluated by Tiramisu (median of runs)
+    double time_ci_low_ms;     // Lower bound of 95% CI of the median
+    double time_ci_high_ms;    // Upper bound of 95% CI of the median
+    double time_p99_ms;        // 99th percentile of the runs (tail latency)
+    double time_cv;            // Run-to-run coefficient of variation
+    double predicted_time_ms;  // Roofline model prediction (-1 if not ranked)
+    
+    // Production costs (-1 if not measured)
+    double compile_time_ms;    // Tiramisu codegen + link
+    int64_t code_size_bytes;   // Size of the generated shared library
+    int64_t scratch_bytes;     // Peak heap scratch memory of one run
     bool is_valid;             // Whether it passes Tiramisu validation
     
-    // GPU optimization properties
+    // Memory-system properties
     bool has_coalescing_violation;     // Whether it violates coalescing
-    bool has_bank_conflict;            // Whether it has bank conflict
+    bool has_bank_conflict;            // Whether it has a bank / cache-set conflict
     int bank_conflict_way;             // Conflict degree (2-way, 4-way, etc.)
     
     // NEW: Multi-access coalescing score
@@ -39,7 +75,13 @@ struct ScheduleConfig {
     // Description
     std::string description;
     
-    ScheduleConfig() : execution_time_ms(-1.0), is_valid(true),
+    ScheduleConfig() : execution_time_ms(-1.0),
+                       time_ci_low_ms(-1.0), time_ci_high_ms(-1.0),
+                       time_p99_ms(-1.0), time_cv(-1.0),
+                       predicted_time_ms(-1.0),
+                       compile_time_ms(-1.0), code_size_bytes(-1),
+                       scratch_bytes(-1),
+                       is_valid(true),
                        has_coalescing_violation(false), 
                        has_bank_conflict(false),
                        bank_conflict_way(0),
@@ -50,16 +92,128 @@ struct ScheduleConfig {
 // Access Pattern Definition
 // ============================================================================
 
+// Extent of an array dimension / trip count of a loop that is not known
+const int64_t kUnknownExtent = -1;
+
 struct AccessPattern {
     std::string array_name;
     std::vector<std::string> indices;  // e.g., ["i", "k"] for A[i][k]
     int64_t access_frequency;          // Access frequency (1=read-only, 2=read-write)
     size_t element_size;               // sizeof(type)
-    int64_t dimension_size;            // Dimension size (for stride calculation)
+    int64_t dimension_size;            // Dimension size (for stride calculation; <= 0: unknown)
     bool is_write;                     // Whether it's a write operation
     
+    // Exact affine access (filled by derive_access_patterns):
+    // subscript r = Σ_c coeffs[r][c] * iterator_names[c] + const
+    std::vector<std::string> iterator_names;
+    std::vector<std::vector<int64_t>> coeffs;
+    // Same access over PLUTO's transformed loops (pluto_get_new_access_func),
+    // columns = schedule levels, outer -> inner
+    std::vector<std::vector<int64_t>> transformed_coeffs;
+    std::vector<bool> transformed_is_loop;  // false for scalar levels
+    // Real per-dimension array extents (row-major, outer -> inner)
+    std::vector<int64_t> extents;
+    
     AccessPattern() : access_frequency(1), element_size(4), 
                       dimension_size(1024), is_write(false) {}
+    
+    bool has_affine_access() const { return !coeffs.empty(); }
+    size_t num_dims() const { return has_affine_access() ? coeffs.size() : indices.size(); }
+    
+    // Extent of dimension r: extents, else dimension_size, else kUnknownExtent
+    int64_t extent(size_t r) const {
+        if (extents.size() == num_dims()) return extents[r];
+        return dimension_size > 0 ? dimension_size : kUnknownExtent;
+    }
+};
+
+// ============================================================================
+// Conflict Analysers - Pluggable bank / cache-set conflict models
+// ============================================================================
+
+class ConflictAnalyzer {
+public:
+    virtual ~ConflictAnalyzer() {}
+    
+    // Conflict degree of the config's tiles (1 = no conflict)
+    virtual int analyze(
+        const ScheduleConfig& config,
+        const std::vector<AccessPattern>& patterns
+    ) = 0;
+    
+    virtual std::string name() const = 0;
+};
+
+// Legacy model: 32 GPU shared-memory banks, tile sizes only
+class GpuBankConflictAnalyzer : public ConflictAnalyzer {
+public:
+    int analyze(const ScheduleConfig& config,
+                const std::vector<AccessPattern>& patterns) override;
+    std::string name() const override { return "gpu-bank"; }
+};
+
+struct CacheLevelGeometry {
+    std::string name;
+    int64_t size_bytes;
+    int64_t line_bytes;
+    int64_t associativity;
+    
+    CacheLevelGeometry(const std::string& n = "L1", int64_t size = 32 * 1024,
+                       int64_t line = 64, int64_t assoc = 8)
+        : name(n), size_bytes(size), line_bytes(line), associativity(assoc) {}
+    
+    int64_t num_sets() const {
+        return std::max<int64_t>(1, size_bytes / (line_bytes * associativity));
+    }
+};
+
+// Set-associative CPU caches: maps every cache line of each array's tile
+// footprint to its set and reports how far the fullest set exceeds an even
+// spread of the lines (or the associativity, if larger). Power-of-two
+// leading dimensions (1024, 2048, ...) make all tile rows land in a few
+// sets and show up as high conflict degrees.
+class CacheSetConflictAnalyzer : public ConflictAnalyzer {
+public:
+    // L1D / L2 geometry of this machine (sysconf), with common defaults
+    CacheSetConflictAnalyzer();
+    explicit CacheSetConflictAnalyzer(const std::vector<CacheLevelGeometry>& levels)
+        : levels_(levels), max_lines_(1 << 16) {}
+    
+    int analyze(const ScheduleConfig& config,
+                const std::vector<AccessPattern>& patterns) override;
+    std::string name() const override { return "cpu-cache-set"; }
+    
+    // Conflict degree of one access pattern's tile at one level
+    int tile_conflict_way(const CacheLevelGeometry& level,
+                          const ScheduleConfig& config,
+                          const AccessPattern& pattern) const;
+    
+    const std::vector<CacheLevelGeometry>& levels() const { return levels_; }
+
+private:
+    std::vector<CacheLevelGeometry> levels_;
+    int64_t max_lines_;  // Cap on simulated footprint lines per tile
+};
+
+// ============================================================================
+// Vector ISA - SIMD register width of the host
+// ============================================================================
+
+struct VectorISA {
+    std::string name;   // "avx512", "avx2", "avx", "sse2", "neon" or "scalar"
+    int width_bytes;    // Vector register width (0: no SIMD)
+    int registers;      // Architectural vector (or scalar) registers
+    
+    VectorISA(const std::string& n = "scalar", int width = 0, int regs = 16)
+        : name(n), width_bytes(width), registers(regs) {}
+    
+    // Widest ISA this CPU supports (cpuid on x86), cached for the process
+    static const VectorISA& detect();
+    
+    // Elements of the given size per vector register
+    int lanes(size_t element_bytes) const {
+        return element_bytes == 0 ? 0 : (int)(width_bytes / (int)element_bytes);
+    }
 };
 
 // ============================================================================
@@ -74,21 +228,45 @@ enum class ConstraintMode {
     NO_CONSTRAINT        // No constraint: accept all
 };
 
+class LegalConfigEnumerator;
+class CandidateBatch;
+
 class PlutoConstraintSolver {
 public:
     PlutoConstraintSolver(PlutoContext* ctx, PlutoOptions* options)
         : context_(ctx), options_(options),
           coalescing_mode_(ConstraintMode::HARD_CONSTRAINT),
-          bank_conflict_mode_(ConstraintMode::SOFT_CONSTRAINT) {}
+          bank_conflict_mode_(ConstraintMode::SOFT_CONSTRAINT),
+          conflict_analyzer_(std::make_shared<CacheSetConflictAnalyzer>()) {}
     
     // Set constraint mode
     void set_coalescing_mode(ConstraintMode mode) { coalescing_mode_ = mode; }
     void set_bank_conflict_mode(ConstraintMode mode) { bank_conflict_mode_ = mode; }
     
+    // Conflict model used by check_bank_conflict (default: CPU cache sets)
+    void set_conflict_analyzer(std::shared_ptr<ConflictAnalyzer> analyzer) {
+        conflict_analyzer_ = analyzer;
+    }
+    
     // NEW: Set access patterns for multi-access coordination
     void set_access_patterns(const std::vector<AccessPattern>& patterns) {
         access_patterns_ = patterns;
     }
+    const std::vector<AccessPattern>& get_access_patterns() const {
+        return access_patterns_;
+    }
+    
+    // Real extents of an array (outer -> inner), used for exact strides
+    void set_array_extents(const std::string& array, const std::vector<int64_t>& extents) {
+        array_extents_[array] = extents;
+    }
+    
+    // Build access patterns from every statement's read/write PlutoAccess
+    // matrices (original and transformed), no manual annotation needed
+    std::vector<AccessPattern> derive_access_patterns(
+        PlutoProg* prog,
+        size_t element_size = 4
+    );
     
     // Method 1: Generate neighbors from optimal
     // Generate variants from PLUTO optimal
@@ -99,23 +277,112 @@ public:
     
     // Method 2: Enumerate all legal loop orders
     // Keep only those satisfying coalescing
-    std::vector<ScheduleConfig> generate_all_legal_configs(
-        int num_loops,
+    // Lazy: loop permutations (dependence-checked, illegal prefixes pruned)
+    // x tile-size vectors, one candidate per next() call
+    LegalConfigEnumerator enumerate_legal_configs(
+        PlutoProg* prog,
         const std::vector<std::string>& loop_names,
+        const std::vector<int>& tile_options = {16, 32, 64, 128, 256},
         bool only_coalesced = true
     );
     
+    // First max_configs candidates of enumerate_legal_configs
+    std::vector<ScheduleConfig> generate_all_legal_configs(
+        PlutoProg* prog,
+        const std::vector<std::string>& loop_names,
+        bool only_coalesced = true,
+        size_t max_configs = 1000
+    );
+    
     // Method 3: Constraint-based ILP sampling
     // Solve PLUTO multiple times with varying weights
+    // (perturbed re-solves first, tile variants fill the remaining slots)
     std::vector<ScheduleConfig> generate_by_constraint_sampling(
         PlutoProg* base_prog,
         int num_samples = 5
     );
     
+    // Run pluto_auto_transform on num_solves copies of the program, each
+    // with its own PlutoContext and a perturbed iterator priority (lexmin
+    // tie-breaking), coefficient bound and fusion heuristic, on parallel
+    // threads. One config per successful solve.
+    std::vector<ScheduleConfig> solve_perturbed_programs(
+        PlutoProg* base_prog,
+        int num_solves
+    );
+    
+    // Stencils: re-solve a copy of the program with PLUTO's diamond tiling
+    // (concurrent start, or full diamonds with full_diamond) and emit one
+    // TRANS_DIAMOND_TILE config per tile size. Empty when PLUTO finds no
+    // concurrent-start band.
+    std::vector<ScheduleConfig> generate_diamond_tiled(
+        PlutoProg* base_prog,
+        bool full_diamond,
+        const std::vector<int>& tile_sizes = {16, 32, 64, 128}
+    );
+    
+    // Per-dimension tile sizes from PLUTO's tile size selection model
+    // (find_tile_sizes on every outermost permutable band), keyed by the
+    // loop each band dimension scans. Empty if the model is not applicable.
+    std::vector<ScheduleConfig::TileSize> model_tile_sizes(PlutoProg* prog);
+    
+    // Outer tile levels around an L1 tile vector, outermost first: an L3
+    // and an L2 level whose footprints fit half of a core's share of that
+    // cache. Sizes grow by doubling from the inner level and stay below the
+    // loop extents; a level that cannot grow is dropped.
+    std::vector<std::vector<ScheduleConfig::TileSize>> hierarchy_tile_levels(
+        const std::vector<ScheduleConfig::TileSize>& inner
+    ) const;
+    
+    // TRANS_PARALLELIZE per statement for the parallel loop of every
+    // outermost permutable band (find_parallel_loops): the outermost
+    // communication-free loop, plus the next parallel loop when the outer
+    // one has fewer tiles than cores; a two-loop wavefront otherwise.
+    // outer_tiles: sizes of the outermost tile level (default: the tile
+    // size model's). Statements whose schedule has no exact decomposition
+    // into loop steps get no tags (their loops have no iterator names)
+    std::vector<Transformation> parallel_transformations(
+        PlutoProg* prog,
+        const std::vector<ScheduleConfig::TileSize>& outer_tiles = {}
+    );
+    
+    // TRANS_VECTORIZE of the config's innermost loop if every access is
+    // unit-stride or invariant along it. The factor is the ISA's lanes for
+    // the widest element type, halved until it fits the loop's trip count
+    // (tile size, else array extent); vectorize() peels the remainder.
+    // False if the loop is skewed / reversed, strided or too short.
+    bool select_vectorization(
+        const ScheduleConfig& config,
+        const VectorISA& isa,
+        Transformation& vectorize
+    ) const;
+    
+    // Register tiles of a tiled single-nest config: unroll-and-jam factors
+    // of the one or two tiled loops directly outside the innermost loop,
+    // powers of two up to PLUTO's ufactor dividing the tile. An access needs
+    // one register per jammed copy it varies in, except that with SIMD the
+    // reads invariant in the innermost loop are broadcast scalars sharing
+    // one register; variants fit the ISA's register file, most jammed
+    // copies first. Empty without an access
+    // invariant in the innermost loop (no register reuse, as in PLUTO's
+    // is_unroll_jam_profitable).
+    std::vector<std::vector<ScheduleConfig::TileSize>> unroll_jam_variants(
+        const ScheduleConfig& config,
+        const VectorISA& isa,
+        size_t max_variants
+    ) const;
+    
+    // Non-uniform neighbourhood around a tile vector: the seed, each
+    // dimension scaled alone, then all dimensions scaled together
+    std::vector<std::vector<ScheduleConfig::TileSize>> tile_size_neighbourhood(
+        const std::vector<ScheduleConfig::TileSize>& seed,
+        size_t max_variants
+    );
+    
     // Helper: Check if config satisfies coalescing
     bool satisfies_coalescing_constraint(const ScheduleConfig& config);
     
-    // NEW: Check for bank conflict
+    // NEW: Check for bank / cache-set conflict (via the conflict analyser)
     bool check_bank_conflict(const ScheduleConfig& config, int& conflict_way);
     
     // NEW: Compute weighted coalescing score
@@ -132,14 +399,24 @@ public:
     
     // Helper: Check config legality
     bool is_legal_config(const ScheduleConfig& config);
+    bool is_legal_tile_size(int size) const { return size > 0 && size <= 1024; }
     
-    // NEW: Filter candidates by constraint mode
-    std::vector<ScheduleConfig> filter_by_constraints(
-        std::vector<ScheduleConfig> candidates
+    // NEW: Filter candidates by constraint mode. Marks the constraint flags
+    // of every candidate and returns the indices of those kept
+    std::vector<size_t> filter_by_constraints(
+        std::vector<ScheduleConfig>& candidates
     );
     
+    // Same on a batch filled directly by a generator; the constraint flags
+    // live in the batch's score columns
+    std::vector<size_t> filter_by_constraints(CandidateBatch& batch);
+    
     // Print PLUTO program info
     void print_pluto_prog_info(PlutoProg* prog, const std::string& title = "PLUTO Program");
+    
+    // Config of prog's current schedule (stmt->trans); on an untransformed
+    // program this is the original loop order and statement sequence
+    ScheduleConfig pluto_prog_to_config(PlutoProg* prog);
 
 private:
     PlutoContext* context_;
@@ -148,19 +425,196 @@ private:
     // Constraint mode settings
     ConstraintMode coalescing_mode_;
     ConstraintMode bank_conflict_mode_;
+    std::shared_ptr<ConflictAnalyzer> conflict_analyzer_;
     
     // NEW: Access pattern list
     std::vector<AccessPattern> access_patterns_;
+    std::map<std::string, std::vector<int64_t>> array_extents_;
     
     // Internal helper functions
-    ScheduleConfig pluto_prog_to_config(PlutoProg* prog);
     std::vector<int> generate_tile_size_variants(int base_size);
+    bool passes_constraints(bool has_coalescing, int conflict_way) const;
+    void log_filtering(size_t num_input, size_t num_kept);
     
+public:
     // NEW: Compute stride for pattern
-    int compute_stride_for_pattern(
+    // Element stride of the pattern along the config's innermost loop
+    // (0 = invariant). Uses the affine access when available.
+    int64_t compute_stride_for_pattern(
         const ScheduleConfig& config,
         const AccessPattern& pattern
+    ) const;
+};
+
+// ============================================================================
+// Legal Config Enumerator - Lazy permutation x tile-size iterator
+// ============================================================================
+
+class LegalConfigEnumerator {
+public:
+    LegalConfigEnumerator(
+        PlutoConstraintSolver* solver,
+        PlutoProg* prog,
+        const std::vector<std::string>& loop_names,
+        const std::vector<int>& tile_options,
+        bool only_coalesced
     );
+    
+    // Produce the next legal candidate; false when the space is exhausted
+    bool next(ScheduleConfig& config);
+    
+    // Append the next legal candidate to the batch columns without building
+    // a config; also false when the nest has more loops than a batch row
+    bool next(CandidateBatch& batch);
+    
+    // Restart from the first permutation
+    void reset();
+    
+    // Statistics
+    uint64_t num_permutations() const { return num_permutations_; }
+    uint64_t num_pruned_prefixes() const { return num_pruned_prefixes_; }
+    
+private:
+    PlutoConstraintSolver* solver_;
+    std::vector<std::string> loop_names_;
+    std::vector<int> tile_options_;
+    bool only_coalesced_;
+    
+    // dep_dirs_[dep][loop]: direction of the dependence along original loop
+    // (DEP_ZERO / DEP_PLUS / DEP_MINUS / DEP_STAR)
+    std::vector<std::vector<char>> dep_dirs_;
+    
+    // DFS state over permutations
+    std::vector<int> perm_;
+    std::vector<int> cursor_;
+    std::vector<bool> used_;
+    std::vector<std::vector<bool>> satisfied_;  // per depth, per dependence
+    int depth_;
+    bool started_;
+    bool exhausted_;
+    
+    // Odometer over tile sizes for the current permutation
+    std::vector<size_t> tile_index_;
+    bool have_perm_;
+    
+    uint64_t num_permutations_;
+    uint64_t num_pruned_prefixes_;
+    
+    void compute_dependence_directions(PlutoProg* prog);
+    bool can_place(int loop, int depth);
+    void place(int loop, int depth);
+    bool advance_permutation();
+    bool advance_tiles();
+    bool advance();
+    ScheduleConfig build_config() const;
+};
+
+// ============================================================================
+// Measurement Result - Real execution statistics
+// ============================================================================
+
+struct MeasurementResult {
+    bool ok;                           // Compiled, loaded and ran successfully
+    double median_ms;                  // Median execution time
+    double ci_low_ms;                  // 95% CI of the median (order statistics)
+    double ci_high_ms;
+    double p99_ms;                     // 99th percentile (nearest rank)
+    double cv;                         // Standard deviation / mean of the runs
+    std::vector<double> samples_ms;    // Raw per-run times
+    std::string error;                 // Failure reason if !ok
+    
+    // Cost of the generated code (-1 if unknown)
+    double compile_ms;                 // Codegen + link wall time
+    int64_t code_size_bytes;           // Shared library size
+    int64_t peak_scratch_bytes;        // Peak live halide_malloc bytes in a run
+    
+    MeasurementResult() : ok(false), median_ms(-1.0),
+                          ci_low_ms(-1.0), ci_high_ms(-1.0),
+                          p99_ms(-1.0), cv(-1.0), compile_ms(-1.0),
+                          code_size_bytes(-1), peak_scratch_bytes(-1) {}
+};
+
+// ============================================================================
+// Selection Policy - Pick one schedule from the measured Pareto frontier
+// ============================================================================
+
+// Objectives of a measured candidate (all minimized)
+enum ScheduleObjective {
+    OBJ_TIME,           // Median time (bank-conflict penalized, as searched)
+    OBJ_P99_TIME,       // 99th percentile time
+    OBJ_CODE_SIZE,      // Generated code size
+    OBJ_COMPILE_TIME,   // Codegen + link time
+    OBJ_SCRATCH,        // Peak scratch memory
+    OBJ_VARIANCE,       // Run-to-run coefficient of variation
+    NUM_SCHEDULE_OBJECTIVES
+};
+
+const char* schedule_objective_name(ScheduleObjective objective);
+
+// Value of one objective for a measured config (+inf if not measured)
+double schedule_objective_value(const ScheduleConfig& config, ScheduleObjective objective);
+
+// Candidates within `tolerance` (relative) of the best `primary` value are
+// acceptable; among those the smallest `secondary` value wins
+struct SelectionPolicy {
+    ScheduleObjective primary;
+    double tolerance;
+    ScheduleObjective secondary;
+    
+    SelectionPolicy() : primary(OBJ_TIME), tolerance(0.0), secondary(OBJ_TIME) {}
+    SelectionPolicy(ScheduleObjective p, double tol, ScheduleObjective s)
+        : primary(p), tolerance(tol), secondary(s) {}
+    
+    // Fastest median (the default)
+    static SelectionPolicy fastest() { return SelectionPolicy(); }
+    
+    // Lowest tail latency instead of the median
+    static SelectionPolicy lowest_p99() {
+        return SelectionPolicy(OBJ_P99_TIME, 0.0, OBJ_TIME);
+    }
+    
+    // e.g. fastest_within(0.05, OBJ_CODE_SIZE): smallest code among the
+    // schedules at most 5% slower than the fastest
+    static SelectionPolicy fastest_within(double tolerance, ScheduleObjective secondary) {
+        return SelectionPolicy(OBJ_TIME, tolerance, secondary);
+    }
+};
+
+// Non-dominated measured configs over all objectives, fastest first
+std::vector<ScheduleConfig> pareto_front(const std::vector<ScheduleConfig>& measured);
+
+// Config chosen by policy among the measured ones (default config if none)
+ScheduleConfig select_by_policy(const std::vector<ScheduleConfig>& measured,
+                                const SelectionPolicy& policy);
+
+// ============================================================================
+// Worker Pool Options - Process-isolated parallel evaluation
+// ============================================================================
+
+struct WorkerPoolOptions {
+    int num_compile_workers;   // Forked codegen + link workers (share cores; 0: cores / 4)
+    int num_measure_workers;   // Forked timing workers (one dedicated core each;
+                               // 0: every core not used by compile workers)
+    double timeout_s;          // Per-candidate kill timeout (compile or run)
+    int num_runs;              // Timed runs per candidate
+    bool enabled;              // Search batches go through the pool (false:
+                               // measured one by one in this process)
+    
+    WorkerPoolOptions() : num_compile_workers(0), num_measure_workers(0),
+                          timeout_s(60.0), num_runs(10), enabled(true) {}
+};
+
+// ============================================================================
+// Racing Options - Successive halving in search_best_config
+// ============================================================================
+
+struct RacingOptions {
+    bool enabled;
+    int initial_runs;   // Runs per candidate in the first round
+    int min_samples;    // Samples per candidate before anyone is eliminated
+    int max_runs;       // Runs per candidate after which the race is decided
+    
+    RacingOptions() : enabled(false), initial_runs(2), min_samples(6), max_runs(20) {}
 };
 
 // ============================================================================
@@ -172,7 +626,19 @@ public:
     TiramisuConfigEvaluator(tiramisu::function* func)
         : tiramisu_func_(func), converter_(func),
           apply_bank_conflict_penalty_(true),
-          bank_conflict_penalty_factor_(2.0) {}
+          bank_conflict_penalty_factor_(2.0),
+          work_dir_("/tmp"),
+          num_warmup_runs_(1),
+          check_legality_(true),
+          deps_ready_(false) {}
+    
+    struct LegalityStats {
+        int isl_checks;          // check_legality_for_function calls
+        int cache_hits;          // Verdicts served from the cache
+        int prefix_rejections;   // Candidates rejected by a cached illegal prefix
+        
+        LegalityStats() : isl_checks(0), cache_hits(0), prefix_rejections(0) {}
+    };
     
     // Set whether to apply bank conflict penalty
     void set_bank_conflict_penalty(bool enable, double factor = 2.0) {
@@ -180,20 +646,104 @@ public:
         bank_conflict_penalty_factor_ = factor;
     }
     
+    // Value of a symbolic buffer extent (e.g. "N") used to allocate buffers
+    void set_parameter_value(const std::string& name, int64_t value) {
+        param_values_[name] = value;
+    }
+    
+    // Directory for generated objects / shared libraries
+    void set_work_dir(const std::string& dir) { work_dir_ = dir; }
+    
+    // Untimed runs before measurement (page faults, cache warm-up)
+    void set_num_warmup_runs(int n) { num_warmup_runs_ = n; }
+    
+    // Computation of every PLUTO statement, in prog->stmts order; required
+    // for multi-statement configs (the function's own computation list
+    // also holds its inputs)
+    void set_statement_computations(const std::vector<tiramisu::computation*>& comps) {
+        statement_comps_ = comps;
+        clear_legality_cache();
+    }
+    
+    // Successive-halving racing: every candidate gets a few runs, the slow
+    // half is dropped and survivors get twice as many runs per round until
+    // the leader's CI separates from the rest (or max_runs is reached)
+    void set_racing(const RacingOptions& options) { racing_ = options; }
+    
+    // Dependence-based legality filter (check_legality; default on)
+    void set_legality_checks(bool enable) { check_legality_ = enable; }
+    
+    // Legality of a config under Tiramisu's dependence analysis
+    // (function::check_legality_for_function on the applied schedule).
+    // Explicit loop orders are checked prefix by prefix first: a prefix
+    // followed by the remaining loops in their original order is legal iff
+    // some completion of the prefix is, so an illegal prefix is cached and
+    // rejects every order starting with it without further isl work.
+    // The dependence analysis runs once, before the evaluator first resets
+    // the schedules, so it sees the declared then/after order: construct the
+    // evaluator once the program's statement order is declared.
+    bool check_legality(tiramisu::computation& comp, const ScheduleConfig& config);
+    
+    // Whether the loop of the config's TRANS_VECTORIZE can run in SIMD
+    // lanes (function::loop_vectorization_is_legal on the config's schedule
+    // without the vectorization); independent of set_legality_checks.
+    // In multi-statement configs the loop is looked up in the computation
+    // of the tag's statement
+    bool vectorization_is_legal(tiramisu::computation& comp, const ScheduleConfig& config);
+    
+    // Whether every single-loop TRANS_PARALLELIZE of the config is free of
+    // loop-carried dependences (function::loop_parallelization_is_legal on
+    // the config's schedule); wavefronts are parallel by construction
+    bool parallelization_is_legal(tiramisu::computation& comp, const ScheduleConfig& config);
+    
+    const LegalityStats& legality_stats() const { return legality_stats_; }
+    void clear_legality_cache() {
+        prefix_verdicts_.clear();
+        config_verdicts_.clear();
+    }
+    
+    // Worker pool used by search_best_config, measure_all_configs and
+    // evaluate_all_configs
+    // (by default measurement gets every core the compile workers do not use)
+    void set_worker_pool(const WorkerPoolOptions& options) { pool_options_ = options; }
+    
+    // Candidates measure_all_configs times at once (measurement workers)
+    int measurement_slots() const;
+    
     // Evaluate single config performance
+    // Returns median time in ms, or -1.0 if compile / run failed
     double evaluate_config(
         tiramisu::computation& comp,
         const ScheduleConfig& config,
         int num_runs = 10
     );
     
+    // Apply config, codegen, dlopen and time num_runs executions
+    MeasurementResult measure_config(
+        tiramisu::computation& comp,
+        const ScheduleConfig& config,
+        int num_runs = 10
+    );
+    
     // Search for optimal config
+    // (measured, if given, receives every successfully measured candidate
+    // with its time, tail, variance and code-cost metrics)
     ScheduleConfig search_best_config(
         tiramisu::computation& comp,
-        const std::vector<ScheduleConfig>& candidates
+        const std::vector<ScheduleConfig>& candidates,
+        std::vector<ScheduleConfig>* measured = nullptr
+    );
+    
+    // Measure every candidate in place: in the worker pool unless it is
+    // disabled; failed candidates are left with is_valid == false
+    void measure_all_configs(
+        tiramisu::computation& comp,
+        std::vector<ScheduleConfig>& candidates
     );
     
     // Batch evaluation (parallel)
+    // Every candidate is compiled and measured in forked worker processes,
+    // so a crashing or hanging schedule only kills its worker
     std::vector<ScheduleConfig> evaluate_all_configs(
         tiramisu::computation& comp,
         std::vector<ScheduleConfig> candidates
@@ -207,10 +757,90 @@ private:
     bool apply_bank_conflict_penalty_;
     double bank_conflict_penalty_factor_;  // Penalty coefficient
     
+    // Measurement settings
+    std::string work_dir_;
+    int num_warmup_runs_;
+    std::map<std::string, int64_t> param_values_;
+    WorkerPoolOptions pool_options_;
+    RacingOptions racing_;
+    std::vector<tiramisu::computation*> statement_comps_;
+    
+    // Legality checks
+    bool check_legality_;
+    bool deps_ready_;
+    std::map<std::string, bool> prefix_verdicts_;   // Loop-order prefix -> legal
+    std::map<std::string, bool> config_verdicts_;   // Schedule (tiled loops) -> legal
+    LegalityStats legality_stats_;
+    
+    // Dependence analysis of the declared program (first legality query or
+    // schedule reset, whichever comes first)
+    void prepare_dependences();
+    
+    // function::reset_schedules, after the dependence analysis
+    void reset_schedules();
+    
+    // Verdict cache key prefix of a computation of this function
+    std::string verdict_scope(const tiramisu::computation& comp) const;
+    
+    // Apply config, run Tiramisu's legality check, reset the schedules
+    bool schedule_is_legal(tiramisu::computation& comp, const ScheduleConfig& config);
+    
+    // Codegen the current schedule into a shared library, returns its path
+    // (empty string on failure); compile time and code size go to cost.
+    // Artifacts are <base>.o / <base>.so (empty base: a fresh unique name).
+    std::string compile_to_shared_library(std::string& error,
+                                          MeasurementResult* cost = nullptr,
+                                          const std::string& base = "");
+    
+    // Unique path prefix for generated objects (dlopen caches handles by path)
+    std::string artifact_base();
+    
+    // Run the generated kernel num_runs times on freshly allocated buffers
+    MeasurementResult run_shared_library(const std::string& so_path, int num_runs);
+    
+    // Median and CI of result.samples_ms
+    static void summarize_samples(MeasurementResult& result);
+    
+    // Compile workers and measurement workers of the pool
+    void pool_layout(int& num_compile, int& num_measure) const;
+    
+    // Compile and measure candidates in forked workers (in place, unsorted)
+    void run_worker_pool(tiramisu::computation& comp,
+                         std::vector<ScheduleConfig>& candidates);
+    
+    // search_best_config with successive-halving racing
+    ScheduleConfig search_best_config_racing(
+        tiramisu::computation& comp,
+        const std::vector<ScheduleConfig>& candidates,
+        std::vector<ScheduleConfig>* measured
+    );
+    
+    // Whether every statement, loop name and loop dimension the config uses
+    // exists in the declared nests; checked before any Tiramisu call
+    bool config_is_lowerable(
+        tiramisu::computation& comp,
+        const ScheduleConfig& config,
+        std::string& error
+    );
+    
     // Apply config to computation
-    void apply_config_to_computation(
+    // (multi-statement configs schedule every statement computation);
+    // false with error set if the config is not lowerable. Checks that need
+    // the lowered loops (unroll-and-jam) fail part-way: reset the schedules
+    bool apply_config_to_computation(
         tiramisu::computation& comp,
-        const ScheduleConfig& config
+        const ScheduleConfig& config,
+        std::string& error
+    );
+    
+    // Loop order + transformations of one statement's loop nest; false
+    // with error set if an unroll-and-jam cannot be lowered on the nest
+    bool apply_nest_schedule(
+        tiramisu::computation& comp,
+        const ScheduleConfig& config,
+        int statement_id,
+        const std::vector<std::string>& default_loop_order,
+        std::string& error
     );
     
     // Check coalescing constraint
@@ -220,10 +850,96 @@ private:
     double compute_penalized_score(const ScheduleConfig& config, double raw_time);
 };
 
+// ============================================================================
+// Roofline Model - Analytical pre-ranking before measurement
+// ============================================================================
+
+// Measured single-core peaks of this machine
+struct MachinePeaks {
+    double peak_gflops;                 // Double-precision multiply-add throughput
+    double nominal_gflops;              // Clock x FMA lanes x 2 pipes x 2 (0: clock unknown)
+    std::vector<double> bandwidth_gbs;  // Read bandwidth of L1, L2, L3, DRAM
+    std::vector<int64_t> capacity_bytes;  // Capacity of L1, L2, L3
+    int num_cores;
+    
+    MachinePeaks() : peak_gflops(0.0), nominal_gflops(0.0), num_cores(1) {}
+    
+    // Micro-benchmarks (FMA chains, streaming reads per cache level, see
+    // machine_peaks.h); the result is cached for the process
+    static const MachinePeaks& measure();
+};
+
+struct RooflinePrediction {
+    size_t candidate_index;             // Index into the ranked candidate list
+    double flops;
+    std::vector<double> bytes_per_level;  // Bytes moved into L1, L2, L3 (from L2, L3, DRAM)
+    double compute_ms;
+    std::vector<double> memory_ms;      // Time bound of each level's traffic
+    double register_ms;                 // L1 -> register loads (cut by register tiles)
+    double predicted_ms;                // max(compute, memory) bound
+    std::string bound;                  // "compute", "L1", "L2", "L3" or "DRAM"
+};
+
+class RooflineModel {
+public:
+    RooflineModel(const PlutoConstraintSolver* solver = nullptr)
+        : solver_(solver), flops_per_iteration_(2.0), has_peaks_(false) {}
+    
+    // Override measured peaks (e.g. vendor numbers, or for reproducibility)
+    void set_machine_peaks(const MachinePeaks& peaks) {
+        peaks_ = peaks;
+        has_peaks_ = true;
+    }
+    const MachinePeaks& machine_peaks();
+    
+    // Trip count of a loop; default: extent of the array dimension it indexes
+    void set_loop_extent(const std::string& loop, int64_t extent) {
+        loop_extents_[loop] = extent;
+    }
+    
+    // Floating-point operations per innermost iteration (default 2: one FMA)
+    void set_flops_per_iteration(double flops) { flops_per_iteration_ = flops; }
+    
+    // Predict one config from its tile footprints and access matrices
+    RooflinePrediction predict(
+        const ScheduleConfig& config,
+        const std::vector<AccessPattern>& patterns
+    );
+    
+    // Predict all candidates, fastest first (fills predicted_time_ms)
+    std::vector<RooflinePrediction> rank(
+        std::vector<ScheduleConfig>& candidates,
+        const std::vector<AccessPattern>& patterns
+    );
+
+private:
+    const PlutoConstraintSolver* solver_;
+    double flops_per_iteration_;
+    std::map<std::string, int64_t> loop_extents_;
+    MachinePeaks peaks_;
+    bool has_peaks_;
+    
+    int64_t trip_count(const std::string& loop,
+                       const std::vector<AccessPattern>& patterns) const;
+};
+
 // ============================================================================
 // Hybrid Optimizer - Complete Workflow
 // ============================================================================
 
+class TuningDatabase;
+
+// Measurement budget of the model-based ("bayesian") strategy
+struct SearchBudget {
+    int max_measurements;   // Candidates compiled and timed (0 = unlimited)
+    double max_seconds;     // Wall-clock limit of the search (0 = unlimited)
+    int initial_samples;    // Measurements before the surrogate is used
+    size_t pool_size;       // Legal candidates the acquisition chooses from
+    
+    SearchBudget() : max_measurements(32), max_seconds(0.0),
+                     initial_samples(6), pool_size(4096) {}
+};
+
 class HybridOptimizer {
 public:
     HybridOptimizer(
@@ -231,7 +947,63 @@ public:
         PlutoOptions* pluto_opts,
         tiramisu::function* tiramisu_func
     ) : solver_(pluto_ctx, pluto_opts),
-        evaluator_(tiramisu_func) {}
+        evaluator_(tiramisu_func),
+        model_(&solver_),
+        model_top_k_(8),
+        isa_(VectorISA::detect()),
+        auto_vectorize_(true),
+        register_tiles_(true),
+        tuning_db_(nullptr) {}
+    
+    // Only the model's top_k candidates are compiled and measured
+    // (0 = measure every candidate)
+    void set_model_top_k(size_t top_k) { model_top_k_ = top_k; }
+    RooflineModel& roofline_model() { return model_; }
+    PlutoConstraintSolver& solver() { return solver_; }
+    
+    // Budget of the "bayesian" strategy
+    void set_search_budget(const SearchBudget& budget) { budget_ = budget; }
+    
+    // How best_config is picked from the measured candidates
+    // (default: fastest median)
+    void set_selection_policy(const SelectionPolicy& policy) { policy_ = policy; }
+    
+    // Legal candidates get their innermost loop vectorized when it is
+    // unit-stride and dependence-free (default on, host ISA width)
+    void set_auto_vectorization(bool enable) { auto_vectorize_ = enable; }
+    void set_vector_isa(const VectorISA& isa) { isa_ = isa; }
+    
+    // Tiled candidates also get register-tile variants (unroll-and-jam of
+    // the loops around the innermost one) in the search space (default on)
+    void set_register_tiling(bool enable) { register_tiles_ = enable; }
+    
+    // Model ranking of candidates, fastest first, without measuring anything
+    std::vector<RooflinePrediction> rank_candidates(
+        std::vector<ScheduleConfig>& candidates
+    );
+    
+    // Consult / update a persistent tuning database in optimize()
+    void set_tuning_database(TuningDatabase* db) { tuning_db_ = db; }
+    
+    // Parameter value used for buffer allocation and the tuning-cache key
+    void set_parameter_value(const std::string& name, int64_t value) {
+        param_values_[name] = value;
+        evaluator_.set_parameter_value(name, value);
+    }
+    
+    // Computation of every PLUTO statement (see TiramisuConfigEvaluator)
+    void set_statement_computations(const std::vector<tiramisu::computation*>& comps) {
+        evaluator_.set_statement_computations(comps);
+    }
+    
+    // Measure one config with the evaluator used by the search
+    MeasurementResult measure(
+        tiramisu::computation& comp,
+        const ScheduleConfig& config,
+        int num_runs = 10
+    ) {
+        return evaluator_.measure_config(comp, config, num_runs);
+    }
     
     // Complete optimization workflow
     struct OptimizationResult {
@@ -248,6 +1020,17 @@ public:
         double best_time_ms;
         double worst_time_ms;
         double average_time_ms;
+        
+        // Served from the tuning database (no search performed)
+        bool from_cache = false;
+        
+        // Roofline predictions of all candidates, fastest first
+        std::vector<RooflinePrediction> predictions;
+        
+        // Measured candidates not dominated on time, p99, code size,
+        // compile time, scratch memory and variance (fastest first);
+        // best_config is chosen from these by the selection policy
+        std::vector<ScheduleConfig> pareto_front;
     };
     
     // Main optimization function
@@ -266,8 +1049,9 @@ public:
     
     OptimizationResult optimize_with_all_legal(
         tiramisu::computation& comp,
-        int num_loops,
-        const std::vector<std::string>& loop_names
+        PlutoProg* base_prog,
+        const std::vector<std::string>& loop_names,
+        size_t max_configs = 1000
     );
     
     OptimizationResult optimize_with_sampling(
@@ -275,10 +1059,74 @@ public:
         PlutoProg* base_prog,
         int num_samples = 5
     );
+    
+    // Stencils: diamond / full-diamond time tiling over a range of tile
+    // sizes; falls back to optimize_with_neighbors when PLUTO finds no
+    // concurrent-start band
+    OptimizationResult optimize_stencil(
+        tiramisu::computation& comp,
+        PlutoProg* base_prog
+    );
+    
+    // Model-based optimization over legal loop orders x per-loop tile sizes
+    // x register tiles: a random-forest surrogate on (loop positions, log2
+    // tile sizes, log2 unroll-and-jam factors) picks the expected-improvement
+    // maximizer until the budget is spent
+    OptimizationResult optimize_with_bayesian(
+        tiramisu::computation& comp,
+        PlutoProg* base_prog,
+        const std::vector<std::string>& loop_names,
+        const SearchBudget& budget
+    );
 
 private:
     PlutoConstraintSolver solver_;
     TiramisuConfigEvaluator evaluator_;
+    RooflineModel model_;
+    size_t model_top_k_;
+    SearchBudget budget_;
+    SelectionPolicy policy_;
+    VectorISA isa_;
+    bool auto_vectorize_;
+    bool register_tiles_;
+    
+    TuningDatabase* tuning_db_;
+    std::map<std::string, int64_t> param_values_;
+    
+    OptimizationResult run_strategy(
+        tiramisu::computation& comp,
+        PlutoProg* base_prog,
+        const std::string& strategy
+    );
+    
+    // Rank with the roofline model and keep the top model_top_k_ candidates
+    // (fills predicted_time_ms of every candidate)
+    std::vector<ScheduleConfig> preselect_by_model(
+        std::vector<ScheduleConfig>& candidates,
+        OptimizationResult& result
+    );
+    
+    // Candidates passing the solver's sanity checks and Tiramisu's
+    // dependence-based legality check
+    std::vector<ScheduleConfig> filter_legal(
+        tiramisu::computation& comp,
+        const std::vector<ScheduleConfig>& candidates
+    );
+    
+    // Append the innermost-loop vectorization to a legal config, if any
+    // (configs that already vectorize are kept). Multi-statement configs
+    // get one per statement whose own innermost loop qualifies
+    void add_vectorization(tiramisu::computation& comp, ScheduleConfig& config);
+    
+    // Append up to per_config register-tile variants of every tiled
+    // candidate (solver's unroll_jam_variants for the ISA)
+    void add_register_tiles(std::vector<ScheduleConfig>& candidates, size_t per_config);
+    
+    // Fill result.pareto_front and pick result.best_config by the policy
+    void select_from_measured(
+        const std::vector<ScheduleConfig>& measured,
+        OptimizationResult& result
+    );
 };
 
 } // namespace pluto_tiramisu
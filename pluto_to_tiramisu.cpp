@@ -3,8 +3,13 @@
  */
 
 #include "pluto_to_tiramisu.h"
+#include "bridge_profiler.h"
+#include "pluto/pluto.h"
 #include <iostream>
 #include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <cstdlib>
 
 using namespace tiramisu;
 
@@ -72,7 +77,7 @@ static void print_pluto_transformation_matrix(PlutoProg *pluto_prog) {
                 }
                 std::cout << std::endl;
             }
-            
+        
         } else {
             std::cout << "│ [No transformation matrix]" << std::endl;
         }
@@ -83,7 +88,8 @@ static void print_pluto_transformation_matrix(PlutoProg *pluto_prog) {
 }
 
 /**
- * 从transformation matrix分析循环顺序
+ * 从transformation matrix近似分析循环顺序（每个hyperplane取系数最大的维度）
+ * 只在精确分解失败（scaling）时使用
  */
 static std::vector<int> extract_loop_order(PlutoMatrix *trans, int dim) {
     std::vector<int> loop_order;
@@ -118,7 +124,7 @@ static std::vector<int> extract_loop_order(PlutoMatrix *trans, int dim) {
 /**
  * 从PLUTO程序提取迭代器名称
  */
-static std::vector<std::string> extract_iterator_names(Stmt *stmt) {
+static std::vector<std::string> extract_iterator_names(const Stmt *stmt) {
     std::vector<std::string> names;
     
     if (stmt->iterators) {
@@ -150,6 +156,331 @@ static std::vector<std::string> extract_iterator_names(Stmt *stmt) {
     return names;
 }
 
+/**
+ * 扩展欧几里得: u*x + v*y = g, g > 0
+ */
+static int64_t extended_gcd(int64_t x, int64_t y, int64_t &u, int64_t &v) {
+    int64_t r0 = x, r1 = y, u0 = 1, u1 = 0, v0 = 0, v1 = 1;
+    while (r1 != 0) {
+        int64_t q = r0 / r1;
+        int64_t t;
+        t = r0 - q * r1; r0 = r1; r1 = t;
+        t = u0 - q * u1; u0 = u1; u1 = t;
+        t = v0 - q * v1; v0 = v1; v1 = t;
+    }
+    if (r0 < 0) {
+        r0 = -r0; u0 = -u0; v0 = -v0;
+    }
+    u = u0;
+    v = v0;
+    return r0;
+}
+
+/**
+ * 精确分解stmt->trans
+ *
+ * 先用幺模行变换把循环hyperplane矩阵T化为单位矩阵: G_m...G_1 T = I，
+ * 于是 T = G_1^-1 ... G_m^-1，从单位schedule出发依次应用 G_m^-1 ... G_1^-1。
+ * 行交换不生成interchange，只记录在置换sigma中（hyperplane → 循环层），
+ * 其余变换作用在sigma映射后的循环层上；最后的循环顺序由loop order完成。
+ */
+ScheduleDecomposition decompose_statement_schedule(const Stmt *stmt, int statement_id) {
+    ScheduleDecomposition result;
+    if (!stmt || !stmt->trans) return result;
+    
+    int dim = stmt->dim;
+    int nrows = stmt->trans->nrows;
+    result.level_of_hyperplane.assign(nrows, -1);
+    
+    std::vector<int> rows;
+    for (int l = 0; l < nrows; l++) {
+        if (!pluto_is_hyperplane_scalar(stmt, l)) rows.push_back(l);
+    }
+    if ((int)rows.size() != dim) return result;
+    
+    std::vector<std::vector<int64_t>> t(dim, std::vector<int64_t>(dim));
+    for (int h = 0; h < dim; h++) {
+        for (int c = 0; c < dim; c++) {
+            t[h][c] = stmt->trans->val[rows[h]][c];
+        }
+    }
+    
+    // 行变换: q < 0 为行p取反，否则 (行p, 行q) ← [[a, b], [c, d]]·(行p, 行q)
+    struct RowOp {
+        int p, q;
+        int64_t a, b, c, d;
+    };
+    std::vector<RowOp> ops;
+    
+    auto combine = [&](int p, int q, int64_t a, int64_t b, int64_t c, int64_t d) {
+        for (int k = 0; k < dim; k++) {
+            int64_t x = t[p][k], y = t[q][k];
+            t[p][k] = a * x + b * y;
+            t[q][k] = c * x + d * y;
+        }
+        ops.push_back({p, q, a, b, c, d});
+    };
+    
+    for (int j = 0; j < dim; j++) {
+        int pivot = -1;
+        for (int r = j; r < dim && pivot < 0; r++) {
+            if (t[r][j] != 0) pivot = r;
+        }
+        if (pivot < 0) return result;  // 不满秩
+        
+        if (pivot != j) combine(j, pivot, 0, 1, 1, 0);
+        
+        // 第j列的gcd聚到行j
+        for (int r = j + 1; r < dim; r++) {
+            if (t[r][j] == 0) continue;
+            int64_t u, v;
+            int64_t x = t[j][j], y = t[r][j];
+            int64_t g = extended_gcd(x, y, u, v);
+            combine(j, r, u, v, -y / g, x / g);
+        }
+        
+        if (t[j][j] < 0) {
+            for (int k = 0; k < dim; k++) t[j][k] = -t[j][k];
+            ops.push_back({j, -1, -1, 0, 0, 1});
+        }
+        if (t[j][j] != 1) return result;  // scaling，不是幺模矩阵
+        
+        for (int r = 0; r < dim; r++) {
+            if (r == j || t[r][j] == 0) continue;
+            combine(j, r, 1, 0, -t[r][j], 1);
+        }
+    }
+    
+    // 逆序应用逆变换; sigma[h]: 当前第h个hyperplane所在的循环层
+    std::vector<std::string> names = extract_iterator_names(stmt);
+    std::vector<int> sigma(dim);
+    for (int h = 0; h < dim; h++) sigma[h] = h;
+    
+    for (auto it = ops.rbegin(); it != ops.rend(); ++it) {
+        const RowOp &op = *it;
+        
+        if (op.q < 0) {
+            Transformation reverse(TRANS_REVERSE);
+            reverse.iterator_names.push_back(names[sigma[op.p]]);
+            reverse.statement_id = statement_id;
+            result.steps.push_back(reverse);
+            continue;
+        }
+        if (op.a == 0 && op.b == 1 && op.c == 1 && op.d == 0) {
+            std::swap(sigma[op.p], sigma[op.q]);
+            continue;
+        }
+        
+        // [[a, b], [c, d]]^-1 = det·[[d, -b], [-c, a]]，det = ±1
+        int64_t det = op.a * op.d - op.b * op.c;
+        int64_t a = det * op.d, b = -det * op.b, c = -det * op.c, d = det * op.a;
+        int outer = sigma[op.p], inner = sigma[op.q];
+        if (outer > inner) {
+            std::swap(outer, inner);
+            std::swap(a, d);
+            std::swap(b, c);
+        }
+        
+        Transformation skew(TRANS_SKEW);
+        skew.iterator_names = {names[outer], names[inner]};
+        skew.coefficients = {(int)a, (int)b, (int)c, (int)d};
+        skew.statement_id = statement_id;
+        result.steps.push_back(skew);
+    }
+    
+    for (int h = 0; h < dim; h++) {
+        result.level_of_hyperplane[rows[h]] = sigma[h];
+    }
+    result.exact = true;
+    return result;
+}
+
+/**
+ * hyperplane level在band内是否无通信并行:
+ * band中语句间、未被band外循环满足的依赖在该层方向均为0
+ */
+static bool band_level_is_parallel(PlutoProg *prog, const Ploop *loop, int level) {
+    for (int d = 0; d < prog->ndeps; d++) {
+        Dep *dep = prog->deps[d];
+        if (IS_RAR(dep->type)) continue;
+        
+        Stmt *src = prog->stmts[dep->src];
+        Stmt *dest = prog->stmts[dep->dest];
+        if (std::find(loop->stmts, loop->stmts + loop->nstmts, src) == loop->stmts + loop->nstmts ||
+            std::find(loop->stmts, loop->stmts + loop->nstmts, dest) == loop->stmts + loop->nstmts) {
+            continue;
+        }
+        if (dep->satisfaction_level >= 0 && dep->satisfaction_level < (int)loop->depth) {
+            continue;
+        }
+        if (!dep->dirvec || dep->dirvec[level] != DEP_ZERO) return false;
+    }
+    return true;
+}
+
+/**
+ * 查找每个permutable band的并行循环（最外层并行层，否则wavefront）
+ */
+std::vector<BandParallelism> find_parallel_loops(PlutoProg *prog) {
+    std::vector<BandParallelism> result;
+    if (!prog || prog->nstmts == 0 || prog->num_hyperplanes == 0) return result;
+    for (int s = 0; s < prog->nstmts; s++) {
+        if (!prog->stmts[s]->trans) return result;
+    }
+    
+    // hyperplane类型，变换后依赖的方向与满足层
+    pluto_detect_hyperplane_types(prog);
+    pluto_compute_dep_directions(prog);
+    pluto_compute_dep_satisfaction(prog);
+    
+    unsigned nbands = 0;
+    Band **bands = pluto_get_outermost_permutable_bands(prog, &nbands);
+    
+    for (unsigned b = 0; b < nbands; b++) {
+        Ploop *loop = bands[b]->loop;
+        
+        std::vector<int> levels;
+        for (unsigned l = loop->depth;
+             l < loop->depth + bands[b]->width && (int)l < prog->num_hyperplanes; l++) {
+            if (prog->hProps[l].type == H_LOOP) levels.push_back(l);
+        }
+        
+        BandParallelism found;
+        found.level = -1;
+        found.inner_level = -1;
+        found.wavefront = false;
+        
+        for (size_t k = 0; k < levels.size() && found.level < 0; k++) {
+            if (!band_level_is_parallel(prog, loop, levels[k])) continue;
+            found.level = levels[k];
+            if (k + 1 < levels.size() && band_level_is_parallel(prog, loop, levels[k + 1])) {
+                found.inner_level = levels[k + 1];
+            }
+        }
+        if (found.level < 0 && levels.size() >= 2) {
+            found.level = levels[0];
+            found.inner_level = levels[1];
+            found.wavefront = true;
+        }
+        if (found.level < 0) continue;
+        
+        for (unsigned k = 0; k < loop->nstmts; k++) {
+            found.statement_id = loop->stmts[k]->id;
+            result.push_back(found);
+        }
+        
+        bridge_log() << "[Bridge] Band at depth " << loop->depth << ": "
+                     << (found.wavefront ? "wavefront over levels " : "parallel level ")
+                     << found.level;
+        if (found.wavefront) bridge_log() << ", " << found.inner_level;
+        bridge_log() << std::endl;
+    }
+    
+    pluto_bands_free(bands, nbands);
+    return result;
+}
+
+/**
+ * 提取diamond tiling的tile band（每个statement一个TRANS_DIAMOND_TILE）
+ */
+std::vector<Transformation> diamond_tile_transformations(PlutoProg *prog, int tile_size) {
+    std::vector<Transformation> result;
+    if (!prog || !prog->is_diamond_tiled || prog->nstmts == 0 || tile_size <= 0) {
+        return result;
+    }
+    for (unsigned s = 0; s < prog->nstmts; s++) {
+        if (!prog->stmts[s]->trans) return result;
+    }
+    
+    pluto_detect_hyperplane_types(prog);
+    pluto_compute_dep_directions(prog);
+    pluto_compute_dep_satisfaction(prog);
+    
+    unsigned nbands = 0;
+    Band **bands = pluto_get_outermost_permutable_bands(prog, &nbands);
+    
+    // Concurrent start只作用于第一个band: 需在depth 0且包含全部statement
+    Band *band = nullptr;
+    for (unsigned b = 0; b < nbands; b++) {
+        if (bands[b]->loop->depth == 0) band = bands[b];
+    }
+    bool ok = band && band->width >= 2 && band->loop->nstmts == prog->nstmts;
+    
+    for (unsigned k = 0; ok && k < band->loop->nstmts; k++) {
+        Stmt *stmt = band->loop->stmts[k];
+        Transformation tile(TRANS_DIAMOND_TILE);
+        tile.statement_id = stmt->id;
+        tile.iterator_names = extract_iterator_names(stmt);
+        tile.tile_sizes.assign(band->width, tile_size);
+        
+        // 循环超平面（scalar层由多statement的after()体现）
+        for (unsigned l = 0; l < stmt->trans->nrows; l++) {
+            if (!pluto_is_hyperplane_loop(stmt, l)) continue;
+            std::vector<int64_t> row(stmt->trans->val[l], stmt->trans->val[l] + stmt->dim);
+            for (int p = 0; p < prog->npar; p++) {
+                if (stmt->trans->val[l][stmt->dim + p] != 0) ok = false;
+            }
+            row.push_back(stmt->trans->val[l][stmt->trans->ncols - 1]);
+            tile.hyperplanes.push_back(row);
+        }
+        if (tile.hyperplanes.size() != stmt->dim) ok = false;
+        if (ok) result.push_back(tile);
+    }
+    if (!ok) result.clear();
+    
+    bridge_log() << "[Bridge] Diamond tiling: "
+                 << (result.empty() ? "no usable concurrent-start band"
+                                    : std::to_string(band->width) + "-wide band at depth 0")
+                 << std::endl;
+    
+    pluto_bands_free(bands, nbands);
+    return result;
+}
+
+/**
+ * diamond tile之后的循环名
+ */
+std::vector<std::string> diamond_loop_names(const Transformation &trans) {
+    std::vector<std::string> names;
+    for (size_t r = 0; r < trans.tile_sizes.size(); r++) {
+        names.push_back("dtile" + std::to_string(r));
+    }
+    
+    size_t n = trans.iterator_names.size();
+    std::vector<std::string> points(trans.hyperplanes.size());
+    std::vector<bool> claimed(n, false);
+    
+    // 单位行取其迭代器
+    for (size_t r = 0; r < points.size(); r++) {
+        int nonzero = 0, iter = -1;
+        for (size_t c = 0; c < n && c < trans.hyperplanes[r].size(); c++) {
+            if (trans.hyperplanes[r][c] != 0) {
+                nonzero++;
+                iter = c;
+            }
+        }
+        if (nonzero == 1 && std::llabs(trans.hyperplanes[r][iter]) == 1 && !claimed[iter]) {
+            points[r] = trans.iterator_names[iter];
+            claimed[iter] = true;
+        }
+    }
+    // 组合行: 取涉及的最外层未占用迭代器
+    for (size_t r = 0; r < points.size(); r++) {
+        if (!points[r].empty()) continue;
+        for (size_t c = 0; c < n && c < trans.hyperplanes[r].size(); c++) {
+            if (trans.hyperplanes[r][c] != 0 && !claimed[c]) {
+                points[r] = trans.iterator_names[c];
+                claimed[c] = true;
+                break;
+            }
+        }
+        if (points[r].empty()) points[r] = "dpoint" + std::to_string(r);
+    }
+    
+    names.insert(names.end(), points.begin(), points.end());
+    return names;
+}
+
 /**
  * 从PLUTO程序提取变换（完整版本 - 支持任意维度）
  */
@@ -157,42 +488,107 @@ std::vector<Transformation>
 PlutoToTiramisuConverter::extract_transformations(PlutoProg *pluto_prog) {
     std::vector<Transformation> transforms;
     
-    std::cout << "[Bridge] Extracting PLUTO transformations (Full Version)..." << std::endl;
+    bridge_log() << "[Bridge] Extracting PLUTO transformations (Full Version)..." << std::endl;
     
-    // 打印PLUTO找到的transformation matrix
-    print_pluto_transformation_matrix(pluto_prog);
+    // 打印PLUTO找到的transformation matrix（仅verbose模式）
+    if (BridgeProfiler::instance().verbose()) {
+        print_pluto_transformation_matrix(pluto_prog);
+    }
     
     if (!pluto_prog || pluto_prog->nstmts == 0) {
-        std::cout << "[Bridge] Warning: No statements to process" << std::endl;
+        bridge_log() << "[Bridge] Warning: No statements to process" << std::endl;
         return transforms;
     }
     
+    // Diamond tiling: band的hyperplane非幺模，整体作为diamond tile输出
+    if (pluto_prog->is_diamond_tiled) {
+        transforms = diamond_tile_transformations(pluto_prog, 32);
+        if (!transforms.empty()) return transforms;
+    }
+    
+    // PLUTO的最外层permutable bands（tile在band上）
+    unsigned nbands = 0;
+    Band **bands = pluto_get_outermost_permutable_bands(pluto_prog, &nbands);
+    std::vector<BandParallelism> parallelism = find_parallel_loops(pluto_prog);
+    
+    // PLUTO的unroll-jam循环（is_unroll_jam_profitable，因子ufactor）
+    PlutoOptions *options = pluto_prog->context ? pluto_prog->context->options : nullptr;
+    unsigned nujloops = 0;
+    Ploop **ujloops = nullptr;
+    if (options && options->unrolljam && options->ufactor > 1) {
+        ujloops = pluto_get_unroll_jam_loops(pluto_prog, &nujloops);
+    }
+    
     // 处理所有statements（不只是第一个）
     for (unsigned s = 0; s < pluto_prog->nstmts; s++) {
         Stmt *stmt = pluto_prog->stmts[s];
         
-        std::cout << "\n[Bridge] Processing statement " << s 
-                  << " (dim=" << stmt->dim << ")" << std::endl;
+        bridge_log() << "\n[Bridge] Processing statement " << s 
+                     << " (dim=" << stmt->dim << ")" << std::endl;
         
         // 提取迭代器名称
         std::vector<std::string> iterator_names = extract_iterator_names(stmt);
         
-        std::cout << "[Bridge] Iterators: ";
+        bridge_log() << "[Bridge] Iterators: ";
         for (const auto& name : iterator_names) {
-            std::cout << name << " ";
+            bridge_log() << name << " ";
         }
-        std::cout << std::endl;
+        bridge_log() << std::endl;
         
         // 分析transformation matrix
         if (stmt->trans && stmt->trans->nrows > 0) {
-            // 提取循环顺序
-            std::vector<int> loop_order = extract_loop_order(stmt->trans, stmt->dim);
+            // 精确分解为skew/reversal + 循环置换
+            ScheduleDecomposition decomposition = decompose_statement_schedule(stmt, s);
+            
+            // 每个hyperplane对应的循环（原迭代器名）
+            std::vector<std::string> hyperplane_loops(stmt->trans->nrows);
+            std::vector<std::string> loop_order;
+            
+            if (decomposition.exact) {
+                for (unsigned l = 0; l < stmt->trans->nrows; l++) {
+                    int level = decomposition.level_of_hyperplane[l];
+                    if (level < 0) continue;
+                    hyperplane_loops[l] = iterator_names[level];
+                    loop_order.push_back(iterator_names[level]);
+                }
+                transforms.insert(transforms.end(), decomposition.steps.begin(),
+                                  decomposition.steps.end());
+                
+                // 选择排序: 每次interchange把一个循环换到位
+                // （loop_dims为iterator_names中的下标）
+                std::vector<std::string> levels = iterator_names;
+                for (size_t k = 0; k < loop_order.size(); k++) {
+                    if (levels[k] == loop_order[k]) continue;
+                    size_t cur = std::find(levels.begin(), levels.end(), loop_order[k]) - levels.begin();
+                    
+                    Transformation swap(TRANS_INTERCHANGE);
+                    for (const auto &name : {levels[k], levels[cur]}) {
+                        swap.loop_dims.push_back(
+                            std::find(iterator_names.begin(), iterator_names.end(), name) -
+                            iterator_names.begin());
+                    }
+                    swap.iterator_names = iterator_names;
+                    swap.statement_id = s;
+                    transforms.push_back(swap);
+                    std::swap(levels[k], levels[cur]);
+                }
+                
+                bridge_log() << "[Bridge] Exact decomposition: "
+                             << decomposition.steps.size() << " skew/reversal steps" << std::endl;
+            } else {
+                // 含scaling: 只能近似为每个hyperplane系数最大的维度（不应用）
+                for (int idx : extract_loop_order(stmt->trans, stmt->dim)) {
+                    loop_order.push_back(iterator_names[idx]);
+                }
+                bridge_log() << "[Bridge] Schedule is not unimodular, loop order is approximate"
+                             << std::endl;
+            }
             
-            std::cout << "[Bridge] Loop order (outer→inner): ";
-            for (int idx : loop_order) {
-                std::cout << iterator_names[idx] << " ";
+            bridge_log() << "[Bridge] Loop order (outer→inner): ";
+            for (const auto &name : loop_order) {
+                bridge_log() << name << " ";
             }
-            std::cout << std::endl;
+            bridge_log() << std::endl;
             
             // 检查GPU coalescing
             int last_hyp = stmt->trans->nrows - 1;
@@ -202,54 +598,125 @@ PlutoToTiramisuConverter::extract_transformations(PlutoProg *pluto_prog) {
                 int innermost_coeff = stmt->trans->val[last_hyp][stmt->dim - 1];
                 is_coalescing = (innermost_coeff >= 1);
                 
-                std::cout << "[Bridge] GPU Coalescing: " 
-                          << (is_coalescing ? "YES ✓" : "NO") << std::endl;
+                bridge_log() << "[Bridge] GPU Coalescing: " 
+                             << (is_coalescing ? "YES ✓" : "NO") << std::endl;
+            }
+            
+            // Tile PLUTO的最外层permutable band（变换后的循环）
+            std::vector<std::string> band_loops;
+            for (unsigned b = 0; b < nbands && decomposition.exact; b++) {
+                Ploop *loop = bands[b]->loop;
+                if (std::find(loop->stmts, loop->stmts + loop->nstmts, stmt) ==
+                    loop->stmts + loop->nstmts) {
+                    continue;
+                }
+                for (unsigned l = loop->depth;
+                     l < loop->depth + bands[b]->width && l < stmt->trans->nrows; l++) {
+                    if (!hyperplane_loops[l].empty()) band_loops.push_back(hyperplane_loops[l]);
+                }
             }
             
             // 根据维度创建合适的变换
             if (stmt->dim >= 2) {
                 Transformation tile(is_coalescing ? TRANS_GPU_TILE : TRANS_TILE);
                 
-                // 动态设置tile维度
-                int max_dims = (stmt->dim < 3) ? stmt->dim : 3;
-                for (int d = 0; d < max_dims; d++) {
-                    tile.loop_dims.push_back(d);
-                }
-                
-                // 设置tile大小（根据维度）
-                if (stmt->dim == 2) {
-                    tile.tile_sizes = {32, 32};
-                } else if (stmt->dim == 3) {
-                    tile.tile_sizes = {32, 32, 32};
+                if (!band_loops.empty()) {
+                    for (const auto &name : band_loops) {
+                        tile.loop_dims.push_back(
+                            std::find(loop_order.begin(), loop_order.end(), name) -
+                            loop_order.begin());
+                    }
+                    tile.tile_sizes.assign(band_loops.size(), 32);
+                    tile.iterator_names = band_loops;
                 } else {
-                    // 更高维度
-                    for (int d = 0; d < stmt->dim; d++) {
-                        tile.tile_sizes.push_back(32);
+                    // 没有band信息: 按原迭代器顺序
+                    int max_dims = (stmt->dim < 3) ? stmt->dim : 3;
+                    for (int d = 0; d < max_dims; d++) {
+                        tile.loop_dims.push_back(d);
                     }
+                    
+                    // 设置tile大小（根据维度）
+                    if (stmt->dim == 2) {
+                        tile.tile_sizes = {32, 32};
+                    } else if (stmt->dim == 3) {
+                        tile.tile_sizes = {32, 32, 32};
+                    } else {
+                        // 更高维度
+                        for (int d = 0; d < stmt->dim; d++) {
+                            tile.tile_sizes.push_back(32);
+                        }
+                    }
+                    
+                    // 存储迭代器名称（用于后续应用）
+                    tile.iterator_names = iterator_names;
                 }
-                
-                // 存储迭代器名称（用于后续应用）
-                tile.iterator_names = iterator_names;
                 tile.statement_id = s;
                 
+                // second_level_tile: 外层L2 tile（PLUTO默认为L1的8倍），再tile其point循环
+                if (!is_coalescing && pluto_prog->context && pluto_prog->context->options &&
+                    pluto_prog->context->options->second_level_tile) {
+                    Transformation outer = tile;
+                    for (auto &size : outer.tile_sizes) {
+                        size *= DEFAULT_SECOND_LEVEL_TILE_SIZE_RATIO;
+                    }
+                    transforms.push_back(outer);
+                }
                 transforms.push_back(tile);
                 
-                std::cout << "[Bridge] Added " 
-                          << (is_coalescing ? "GPU" : "CPU") 
-                          << " tile: ";
+                bridge_log() << "[Bridge] Added " 
+                             << (is_coalescing ? "GPU" : "CPU") 
+                             << " tile: ";
                 for (auto size : tile.tile_sizes) {
-                    std::cout << size << "×";
+                    bridge_log() << size << "×";
+                }
+                bridge_log() << "\b " << std::endl;
+                
+                // Unroll-and-jam: tile内最内层的unroll-jam循环（寄存器tile）
+                std::string jam_loop;
+                for (unsigned u = 0; !is_coalescing && u < nujloops; u++) {
+                    Ploop *loop = ujloops[u];
+                    bool has_stmt = std::find(loop->stmts, loop->stmts + loop->nstmts, stmt) !=
+                                    loop->stmts + loop->nstmts;
+                    if (!has_stmt || loop->depth >= stmt->trans->nrows) continue;
+                    const std::string &name = hyperplane_loops[loop->depth];
+                    if (std::find(band_loops.begin(), band_loops.end(), name) != band_loops.end()) {
+                        jam_loop = name;
+                    }
+                }
+                if (!jam_loop.empty()) {
+                    Transformation jam(TRANS_UNROLL_JAM);
+                    jam.iterator_names.push_back(jam_loop);
+                    jam.tile_sizes.push_back(options->ufactor);
+                    jam.statement_id = s;
+                    transforms.push_back(jam);
+                    bridge_log() << "[Bridge] Added unroll-and-jam: " << jam_loop << "×"
+                                 << options->ufactor << std::endl;
                 }
-                std::cout << "\b " << std::endl;
+            }
+            
+            // 并行化: band的最外层并行循环，或wavefront
+            for (const auto &par : parallelism) {
+                if (par.statement_id != (int)s || !decomposition.exact) continue;
+                
+                Transformation parallel(TRANS_PARALLELIZE);
+                parallel.iterator_names.push_back(hyperplane_loops[par.level]);
+                if (par.wavefront) {
+                    parallel.iterator_names.push_back(hyperplane_loops[par.inner_level]);
+                }
+                parallel.statement_id = s;
+                transforms.push_back(parallel);
             }
         } else {
-            std::cout << "[Bridge] No transformation matrix for statement " 
-                      << s << std::endl;
+            bridge_log() << "[Bridge] No transformation matrix for statement " 
+                         << s << std::endl;
         }
     }
     
-    std::cout << "\n[Bridge] Extracted " << transforms.size() 
-              << " transformations total" << std::endl;
+    pluto_bands_free(bands, nbands);
+    if (ujloops) pluto_loops_free(ujloops, nujloops);
+    
+    bridge_log() << "\n[Bridge] Extracted " << transforms.size() 
+                 << " transformations total" << std::endl;
     
     return transforms;
 }
@@ -261,8 +728,8 @@ void PlutoToTiramisuConverter::apply_transformations(
     computation &comp,
     const std::vector<Transformation> &transforms) {
     
-    std::cout << "[Bridge] Applying " << transforms.size() 
-              << " transformations to Tiramisu..." << std::endl;
+    bridge_log() << "[Bridge] Applying " << transforms.size() 
+                 << " transformations to Tiramisu..." << std::endl;
     
     for (const auto &trans : transforms) {
         switch (trans.type) {
@@ -275,13 +742,37 @@ void PlutoToTiramisuConverter::apply_transformations(
             case TRANS_INTERCHANGE:
                 apply_interchange(comp, trans);
                 break;
+            case TRANS_SKEW:
+                apply_skew(comp, trans);
+                break;
+            case TRANS_REVERSE:
+                apply_reverse(comp, trans);
+                break;
+            case TRANS_DIAMOND_TILE:
+                apply_diamond_tile(comp, trans);
+                break;
+            case TRANS_SPLIT:
+                apply_split(comp, trans);
+                break;
+            case TRANS_PARALLELIZE:
+                apply_parallelize(comp, trans);
+                break;
+            case TRANS_VECTORIZE:
+                apply_vectorize(comp, trans);
+                break;
+            case TRANS_UNROLL:
+                apply_unroll(comp, trans);
+                break;
+            case TRANS_UNROLL_JAM:
+                apply_unroll_jam(comp, trans);
+                break;
             default:
-                std::cout << "[Bridge] Warning: Unsupported transformation type" 
-                          << std::endl;
+                bridge_log() << "[Bridge] Warning: Unsupported transformation type" 
+                             << std::endl;
         }
     }
     
-    std::cout << "[Bridge] All transformations applied" << std::endl;
+    bridge_log() << "[Bridge] All transformations applied" << std::endl;
 }
 
 /**
@@ -296,20 +787,20 @@ void PlutoToTiramisuConverter::apply_gpu_tile(
         return;
     }
     
-    std::cout << "[Bridge] Applying GPU tile: ";
+    bridge_log() << "[Bridge] Applying GPU tile: ";
     for (size_t i = 0; i < trans.tile_sizes.size(); i++) {
-        std::cout << trans.tile_sizes[i];
-        if (i < trans.tile_sizes.size() - 1) std::cout << "×";
+        bridge_log() << trans.tile_sizes[i];
+        if (i < trans.tile_sizes.size() - 1) bridge_log() << "×";
     }
-    std::cout << std::endl;
+    bridge_log() << std::endl;
     
     // 使用动态迭代器名称
     if (trans.iterator_names.size() >= 2) {
-        std::cout << "[Bridge] Using iterators: ";
+        bridge_log() << "[Bridge] Using iterators: ";
         for (const auto& name : trans.iterator_names) {
-            std::cout << name << " ";
+            bridge_log() << name << " ";
         }
-        std::cout << std::endl;
+        bridge_log() << std::endl;
         
         // 创建var对象
         var v0(trans.iterator_names[0].c_str());
@@ -319,78 +810,170 @@ void PlutoToTiramisuConverter::apply_gpu_tile(
         if (trans.tile_sizes.size() == 2) {
             comp.gpu_tile(v0, v1, trans.tile_sizes[0], trans.tile_sizes[1]);
             
-            std::cout << "[Bridge] 2D GPU tile applied:" << std::endl;
-            std::cout << "[Bridge]   " << trans.iterator_names[0] << ": " 
-                      << trans.tile_sizes[0] << " (blockIdx.y, threadIdx.y)" << std::endl;
-            std::cout << "[Bridge]   " << trans.iterator_names[1] << ": " 
-                      << trans.tile_sizes[1] << " (blockIdx.x, threadIdx.x)" << std::endl;
+            bridge_log() << "[Bridge] 2D GPU tile applied:" << std::endl;
+            bridge_log() << "[Bridge]   " << trans.iterator_names[0] << ": " 
+                         << trans.tile_sizes[0] << " (blockIdx.y, threadIdx.y)" << std::endl;
+            bridge_log() << "[Bridge]   " << trans.iterator_names[1] << ": " 
+                         << trans.tile_sizes[1] << " (blockIdx.x, threadIdx.x)" << std::endl;
         } else if (trans.tile_sizes.size() == 3 && trans.iterator_names.size() >= 3) {
             var v2(trans.iterator_names[2].c_str());
             comp.gpu_tile(v0, v1, v2, 
                          trans.tile_sizes[0], trans.tile_sizes[1], trans.tile_sizes[2]);
             
-            std::cout << "[Bridge] 3D GPU tile applied:" << std::endl;
-            std::cout << "[Bridge]   " << trans.iterator_names[0] << ": " 
-                      << trans.tile_sizes[0] << " (blockIdx.z, threadIdx.z)" << std::endl;
-            std::cout << "[Bridge]   " << trans.iterator_names[1] << ": " 
-                      << trans.tile_sizes[1] << " (blockIdx.y, threadIdx.y)" << std::endl;
-            std::cout << "[Bridge]   " << trans.iterator_names[2] << ": " 
-                      << trans.tile_sizes[2] << " (blockIdx.x, threadIdx.x)" << std::endl;
+            bridge_log() << "[Bridge] 3D GPU tile applied:" << std::endl;
+            bridge_log() << "[Bridge]   " << trans.iterator_names[0] << ": " 
+                         << trans.tile_sizes[0] << " (blockIdx.z, threadIdx.z)" << std::endl;
+            bridge_log() << "[Bridge]   " << trans.iterator_names[1] << ": " 
+                         << trans.tile_sizes[1] << " (blockIdx.y, threadIdx.y)" << std::endl;
+            bridge_log() << "[Bridge]   " << trans.iterator_names[2] << ": " 
+                         << trans.tile_sizes[2] << " (blockIdx.x, threadIdx.x)" << std::endl;
         } else {
-            std::cout << "[Bridge] Warning: " << trans.tile_sizes.size() 
-                      << "D GPU tiling not fully supported, using 2D" << std::endl;
+            bridge_log() << "[Bridge] Warning: " << trans.tile_sizes.size() 
+                         << "D GPU tiling not fully supported, using 2D" << std::endl;
             comp.gpu_tile(v0, v1, trans.tile_sizes[0], trans.tile_sizes[1]);
         }
         
-        std::cout << "[Bridge] ✓ Memory coalescing enabled" << std::endl;
+        bridge_log() << "[Bridge] ✓ Memory coalescing enabled" << std::endl;
     } else {
         std::cerr << "[Bridge] Error: Not enough iterator names" << std::endl;
     }
 }
 
 /**
- * 应用普通tile（通用版本）
+ * 应用普通tile（通用版本 - 任意维度）
+ *
+ * tile后外层循环命名为 name_outer，内层为 name_inner。
+ * 2D/3D且相邻时直接使用comp.tile，否则对每一维split后
+ * 把所有outer循环交换到inner循环之前。
  */
 void PlutoToTiramisuConverter::apply_tile(
     computation &comp,
     const Transformation &trans) {
     
-    if (trans.tile_sizes.size() < 2) {
-        std::cerr << "[Bridge] Error: Tile needs at least 2 dimensions" << std::endl;
+    if (trans.tile_sizes.empty()) {
+        std::cerr << "[Bridge] Error: Tile needs at least 1 dimension" << std::endl;
         return;
     }
     
-    std::cout << "[Bridge] Applying CPU tile: ";
+    bridge_log() << "[Bridge] Applying CPU tile: ";
     for (size_t i = 0; i < trans.tile_sizes.size(); i++) {
-        std::cout << trans.tile_sizes[i];
-        if (i < trans.tile_sizes.size() - 1) std::cout << "×";
+        bridge_log() << trans.tile_sizes[i];
+        if (i < trans.tile_sizes.size() - 1) bridge_log() << "×";
     }
-    std::cout << std::endl;
+    bridge_log() << std::endl;
     
-    // 使用动态迭代器名称
-    if (trans.iterator_names.size() >= 2) {
-        var v0(trans.iterator_names[0].c_str());
-        var v1(trans.iterator_names[1].c_str());
-        
-        if (trans.tile_sizes.size() == 2) {
-            comp.tile(v0, v1, trans.tile_sizes[0], trans.tile_sizes[1]);
-        } else if (trans.tile_sizes.size() == 3 && trans.iterator_names.size() >= 3) {
-            var v2(trans.iterator_names[2].c_str());
-            comp.tile(v0, v1, v2, 
-                     trans.tile_sizes[0], trans.tile_sizes[1], trans.tile_sizes[2]);
+    // 要tile的循环（当前名字）
+    std::vector<std::string> names;
+    std::vector<int> sizes;
+    if (!trans.iterator_names.empty()) {
+        size_t n = std::min(trans.iterator_names.size(), trans.tile_sizes.size());
+        for (size_t d = 0; d < n; d++) {
+            if (trans.tile_sizes[d] <= 0) continue;
+            // 已tile过的循环: 取最内层(point)循环，实现多级tile
+            names.push_back(resolve_loop_name(comp, trans.iterator_names[d], true));
+            sizes.push_back(trans.tile_sizes[d]);
         }
-        
-        std::cout << "[Bridge] CPU tile applied for dimensions: ";
-        for (size_t i = 0; i < std::min(trans.iterator_names.size(), trans.tile_sizes.size()); i++) {
-            std::cout << trans.iterator_names[i] << " ";
+    } else {
+        // Fallback: 按loop_dims（或最外层开始）取当前循环
+        std::vector<std::string> levels = comp.get_loop_level_names();
+        for (size_t d = 0; d < trans.tile_sizes.size(); d++) {
+            size_t level = (d < trans.loop_dims.size()) ? trans.loop_dims[d] : d;
+            if (level >= levels.size() || trans.tile_sizes[d] <= 0) continue;
+            names.push_back(levels[level]);
+            sizes.push_back(trans.tile_sizes[d]);
         }
-        std::cout << std::endl;
+    }
+    
+    if (names.empty()) {
+        std::cerr << "[Bridge] Error: No loops to tile" << std::endl;
+        return;
+    }
+    
+    // 检查这些循环是否按顺序相邻
+    std::vector<std::string> levels = comp.get_loop_level_names();
+    bool consecutive = true;
+    int first = -1;
+    for (size_t d = 0; d < names.size(); d++) {
+        auto it = std::find(levels.begin(), levels.end(), names[d]);
+        if (it == levels.end()) {
+            std::cerr << "[Bridge] Error: Unknown loop " << names[d] << std::endl;
+            return;
+        }
+        int pos = it - levels.begin();
+        if (d == 0) first = pos;
+        else if (pos != first + (int)d) consecutive = false;
+    }
+    
+    std::vector<std::string> outer, inner;
+    for (const auto &name : names) {
+        outer.push_back(name + "_outer");
+        inner.push_back(name + "_inner");
+    }
+    
+    if (consecutive && names.size() == 2) {
+        comp.tile(var(names[0]), var(names[1]), sizes[0], sizes[1],
+                  var(outer[0]), var(outer[1]), var(inner[0]), var(inner[1]));
+    } else if (consecutive && names.size() == 3) {
+        comp.tile(var(names[0]), var(names[1]), var(names[2]),
+                  sizes[0], sizes[1], sizes[2],
+                  var(outer[0]), var(outer[1]), var(outer[2]),
+                  var(inner[0]), var(inner[1]), var(inner[2]));
     } else {
-        // Fallback to default names
-        var i("i"), j("j");
-        comp.tile(i, j, trans.tile_sizes[0], trans.tile_sizes[1]);
-        std::cout << "[Bridge] CPU tile applied (using default names)" << std::endl;
+        // 任意维度: split每一维，然后 (o0,i0,o1,i1,...) → (o0,o1,...,i0,i1,...)
+        for (size_t d = 0; d < names.size(); d++) {
+            comp.split(var(names[d]), sizes[d], var(outer[d]), var(inner[d]));
+        }
+        std::vector<std::string> order = outer;
+        order.insert(order.end(), inner.begin(), inner.end());
+        apply_loop_order(comp, order);
+    }
+    
+    bridge_log() << "[Bridge] CPU tile applied for dimensions: ";
+    for (const auto &name : names) {
+        bridge_log() << name << " ";
+    }
+    bridge_log() << std::endl;
+}
+
+/**
+ * 通过interchange调整循环顺序
+ */
+void PlutoToTiramisuConverter::apply_loop_order(
+    computation &comp,
+    const std::vector<std::string> &order) {
+    
+    std::vector<std::string> levels = comp.get_loop_level_names();
+    
+    // order中的循环当前占据的位置（排序后依次填入目标顺序）
+    std::vector<std::string> target;
+    std::vector<int> slots;
+    for (const auto &name : order) {
+        auto it = std::find(levels.begin(), levels.end(), name);
+        if (it == levels.end()) {
+            std::cerr << "[Bridge] Error: Unknown loop " << name
+                      << " in loop order" << std::endl;
+            return;
+        }
+        target.push_back(name);
+        slots.push_back(it - levels.begin());
+    }
+    std::sort(slots.begin(), slots.end());
+    
+    // 选择排序：每个slot最多一次interchange
+    for (size_t k = 0; k < slots.size(); k++) {
+        int want = slots[k];
+        if (levels[want] == target[k]) continue;
+        
+        int cur = std::find(levels.begin(), levels.end(), target[k]) - levels.begin();
+        comp.interchange(var(levels[want]), var(levels[cur]));
+        std::swap(levels[want], levels[cur]);
+    }
+    
+    bridge_log() << "[Bridge] Loop order (outer→inner): ";
+    for (const auto &name : levels) {
+        bridge_log() << name << " ";
     }
+    bridge_log() << std::endl;
 }
 
 /**
@@ -400,20 +983,20 @@ void PlutoToTiramisuConverter::apply_interchange(
     computation &comp,
     const Transformation &trans) {
     
-    std::cout << "[Bridge] Applying interchange" << std::endl;
+    bridge_log() << "[Bridge] Applying interchange" << std::endl;
     
     if (trans.loop_dims.size() >= 2 && trans.iterator_names.size() >= 2) {
         int dim1 = trans.loop_dims[0];
         int dim2 = trans.loop_dims[1];
         
         if (dim1 < trans.iterator_names.size() && dim2 < trans.iterator_names.size()) {
-            var v1(trans.iterator_names[dim1].c_str());
-            var v2(trans.iterator_names[dim2].c_str());
+            std::string n1 = resolve_loop_name(comp, trans.iterator_names[dim1], false);
+            std::string n2 = resolve_loop_name(comp, trans.iterator_names[dim2], false);
             
-            comp.interchange(v1, v2);
+            comp.interchange(var(n1), var(n2));
             
-            std::cout << "[Bridge] Interchanged " << trans.iterator_names[dim1] 
-                      << " ↔ " << trans.iterator_names[dim2] << std::endl;
+            bridge_log() << "[Bridge] Interchanged " << n1 
+                         << " ↔ " << n2 << std::endl;
         } else {
             std::cerr << "[Bridge] Error: Invalid loop dimensions for interchange" << std::endl;
         }
@@ -421,8 +1004,379 @@ void PlutoToTiramisuConverter::apply_interchange(
         // Fallback
         var i("i"), j("j");
         comp.interchange(i, j);
-        std::cout << "[Bridge] Interchange applied (using default names)" << std::endl;
+        bridge_log() << "[Bridge] Interchange applied (using default names)" << std::endl;
+    }
+}
+
+/**
+ * 原迭代器name的一个未被当前循环使用的派生名: name_<suffix>, name_<suffix>2, ...
+ */
+static std::string fresh_loop_name(
+    computation &comp,
+    const std::string &name,
+    const std::string &suffix) {
+    
+    std::vector<std::string> levels = comp.get_loop_level_names();
+    std::string candidate = name + "_" + suffix;
+    for (int k = 2; std::find(levels.begin(), levels.end(), candidate) != levels.end(); k++) {
+        candidate = name + "_" + suffix + std::to_string(k);
+    }
+    return candidate;
+}
+
+/**
+ * 应用skew
+ *
+ * 有coefficients时为一般的幺模2×2变换（精确分解产生）:
+ * (i, j) → (alpha*i + beta*j, gamma*i + sigma*j)，使用Tiramisu的6参数skew；
+ * 否则 (i, j) → (i + f*j, j')，使用 skew(i, j, a, b)，a=1, b=factor
+ */
+void PlutoToTiramisuConverter::apply_skew(
+    computation &comp,
+    const Transformation &trans) {
+    
+    bool general = trans.coefficients.size() == 4;
+    if (trans.iterator_names.size() < 2 || (!general && trans.factor == 0)) {
+        std::cerr << "[Bridge] Error: Skew needs 2 iterators and a non-zero factor"
+                  << std::endl;
+        return;
+    }
+    
+    std::string i = resolve_loop_name(comp, trans.iterator_names[0], false);
+    std::string j = resolve_loop_name(comp, trans.iterator_names[1], false);
+    
+    if (general) {
+        const std::vector<int> &c = trans.coefficients;
+        if (std::abs(c[0] * c[3] - c[1] * c[2]) != 1) {
+            std::cerr << "[Bridge] Error: Skew matrix is not unimodular" << std::endl;
+            return;
+        }
+        
+        std::string ni = fresh_loop_name(comp, trans.iterator_names[0], "sk");
+        std::string nj = fresh_loop_name(comp, trans.iterator_names[1], "sk");
+        comp.skew(var(i), var(j), c[0], c[1], c[2], c[3], var(ni), var(nj));
+        
+        bridge_log() << "[Bridge] Skewed (" << i << ", " << j << ") by ["
+                     << c[0] << " " << c[1] << "; " << c[2] << " " << c[3] << "]"
+                     << std::endl;
+        return;
+    }
+    
+    comp.skew(var(i), var(j), 1, trans.factor, var(i + "_sk"), var(j + "_sk"));
+    
+    bridge_log() << "[Bridge] Skewed " << i << " by " << trans.factor
+                 << "*" << j << std::endl;
+}
+
+/**
+ * 应用loop reversal: name → name_rv（逆序执行）
+ */
+void PlutoToTiramisuConverter::apply_reverse(
+    computation &comp,
+    const Transformation &trans) {
+    
+    if (trans.iterator_names.empty()) {
+        std::cerr << "[Bridge] Error: Reversal needs an iterator" << std::endl;
+        return;
     }
+    
+    std::string name = resolve_loop_name(comp, trans.iterator_names[0], false);
+    comp.loop_reversal(var(name), var(fresh_loop_name(comp, trans.iterator_names[0], "rv")));
+    
+    bridge_log() << "[Bridge] Reversed " << name << std::endl;
+}
+
+/**
+ * 应用diamond tile（time tiling）
+ *
+ * band各行的tile坐标 T_r = floor(h_r(x) / size_r)，schedule改为
+ *   [w, T_2, ..., T_k, h_1(x), ..., h_n(x)]，w = T_1 + ... + T_k
+ * band的依赖在每个h_r上非负，同一波前w内的tile互不依赖，T_2并行；
+ * tile内按PLUTO的超平面顺序执行。须作用于尚未变换的循环。
+ */
+void PlutoToTiramisuConverter::apply_diamond_tile(
+    computation &comp,
+    const Transformation &trans) {
+    
+    size_t n = trans.iterator_names.size();
+    size_t k = trans.tile_sizes.size();
+    if (k < 2 || trans.hyperplanes.size() != n || comp.get_loop_level_names().size() != n) {
+        std::cerr << "[Bridge] Error: Diamond tile needs a >= 2-wide band on an untransformed nest"
+                  << std::endl;
+        return;
+    }
+    
+    // schedule的值域: name[dup, s0, x0, s1, x1, ..., s_n]（s为static维）
+    const std::string &range = comp.get_name();
+    std::string in = range + "[d, s0";
+    for (size_t j = 0; j < n; j++) {
+        in += ", x" + std::to_string(j) + ", s" + std::to_string(j + 1);
+    }
+    in += "]";
+    
+    std::vector<std::string> rows;
+    for (const auto &h : trans.hyperplanes) {
+        std::string affine;
+        for (size_t j = 0; j <= n && j < h.size(); j++) {
+            if (h[j] == 0) continue;
+            affine += h[j] < 0 ? " - " : (affine.empty() ? "" : " + ");
+            affine += std::to_string(std::llabs(h[j]));
+            if (j < n) affine += "*x" + std::to_string(j);
+        }
+        rows.push_back(affine.empty() ? "0" : affine);
+    }
+    
+    std::vector<std::string> tiles;
+    for (size_t r = 0; r < k; r++) {
+        tiles.push_back("floor((" + rows[r] + ")/" + std::to_string(trans.tile_sizes[r]) + ")");
+    }
+    
+    std::string out = range + "[d, s0, " + tiles[0];
+    for (size_t r = 1; r < k; r++) out += " + " + tiles[r];
+    for (size_t r = 1; r < k; r++) out += ", 0, " + tiles[r];
+    for (size_t r = 0; r < n; r++) out += ", 0, " + rows[r];
+    out += ", 0]";
+    
+    comp.apply_transformation_on_schedule("{ " + in + " -> " + out + " }");
+    comp.set_loop_level_names(diamond_loop_names(trans));
+    comp.parallelize(var("dtile1"));
+    
+    bridge_log() << "[Bridge] Diamond-tiled " << comp.get_name() << ": " << k
+                 << " tile loops (dtile0 wavefront, dtile1 parallel)" << std::endl;
+}
+
+/**
+ * 应用split: name → name_outer, name_inner
+ */
+void PlutoToTiramisuConverter::apply_split(
+    computation &comp,
+    const Transformation &trans) {
+    
+    if (trans.iterator_names.empty() || trans.factor <= 0) {
+        std::cerr << "[Bridge] Error: Split needs an iterator and a positive factor"
+                  << std::endl;
+        return;
+    }
+    
+    std::string name = resolve_loop_name(comp, trans.iterator_names[0], true);
+    comp.split(var(name), trans.factor, var(name + "_outer"), var(name + "_inner"));
+    
+    bridge_log() << "[Bridge] Split " << name << " by " << trans.factor << std::endl;
+}
+
+/**
+ * 并行化（tile后为外层tile循环）
+ *
+ * 两个迭代器时为wavefront: 对两者的外层循环做 (a, b) → (a + b, b) 的skew，
+ * 外层按波前顺序执行，b并行（要求a、b在同一permutable band中）
+ */
+void PlutoToTiramisuConverter::apply_parallelize(
+    computation &comp,
+    const Transformation &trans) {
+    
+    if (trans.iterator_names.empty()) {
+        std::cerr << "[Bridge] Error: Parallelize needs an iterator" << std::endl;
+        return;
+    }
+    
+    if (trans.iterator_names.size() >= 2) {
+        std::string a = resolve_loop_name(comp, trans.iterator_names[0], false);
+        std::string b = resolve_loop_name(comp, trans.iterator_names[1], false);
+        std::string na = fresh_loop_name(comp, trans.iterator_names[0], "wf");
+        std::string nb = fresh_loop_name(comp, trans.iterator_names[1], "wf");
+        
+        comp.skew(var(a), var(b), 1, 1, 0, 1, var(na), var(nb));
+        comp.parallelize(var(nb));
+        
+        bridge_log() << "[Bridge] Wavefront over " << a << ", " << b
+                     << "; parallelized " << nb << std::endl;
+        return;
+    }
+    
+    std::string name = resolve_loop_name(comp, trans.iterator_names[0], false);
+    comp.parallelize(var(name));
+    
+    bridge_log() << "[Bridge] Parallelized " << name << std::endl;
+}
+
+/**
+ * 向量化（tile后为内层point循环）
+ */
+void PlutoToTiramisuConverter::apply_vectorize(
+    computation &comp,
+    const Transformation &trans) {
+    
+    if (trans.iterator_names.empty() || trans.factor <= 1) {
+        std::cerr << "[Bridge] Error: Vectorize needs an iterator and a factor > 1"
+                  << std::endl;
+        return;
+    }
+    
+    std::string name = resolve_loop_name(comp, trans.iterator_names[0], true);
+    comp.vectorize(var(name), trans.factor);
+    
+    bridge_log() << "[Bridge] Vectorized " << name << " (width "
+                 << trans.factor << ")" << std::endl;
+}
+
+/**
+ * 展开（tile后为内层point循环）
+ */
+void PlutoToTiramisuConverter::apply_unroll(
+    computation &comp,
+    const Transformation &trans) {
+    
+    if (trans.iterator_names.empty() || trans.factor <= 1) {
+        std::cerr << "[Bridge] Error: Unroll needs an iterator and a factor > 1"
+                  << std::endl;
+        return;
+    }
+    
+    std::string name = resolve_loop_name(comp, trans.iterator_names[0], true);
+    comp.unroll(var(name), trans.factor);
+    
+    bridge_log() << "[Bridge] Unrolled " << name << " by " << trans.factor << std::endl;
+}
+
+/**
+ * 应用unroll-and-jam（寄存器tile）
+ *
+ * 被jam的循环（相邻，外→内）各split为 name_outer / name_inner，
+ * inner循环移到其下方所有循环之内，再完全unroll:
+ *   (i, k, j) → (i_outer, k_outer, j, i_inner, k_inner)
+ * 最内层循环仍可vectorize（Halide先unroll再vectorize，得到jam后的向量体）。
+ */
+void PlutoToTiramisuConverter::apply_unroll_jam(
+    computation &comp,
+    const Transformation &trans) {
+    
+    std::vector<std::string> names;
+    std::string error;
+    if (!unroll_jam_is_applicable(comp, trans, names, error)) {
+        std::cerr << "[Bridge] Error: " << error << std::endl;
+        return;
+    }
+    
+    std::vector<int> factors;
+    for (size_t d = 0; d < trans.iterator_names.size() && d < trans.tile_sizes.size(); d++) {
+        if (trans.tile_sizes[d] > 1) factors.push_back(trans.tile_sizes[d]);
+    }
+    std::vector<std::string> levels = comp.get_loop_level_names();
+    size_t first = std::find(levels.begin(), levels.end(), names[0]) - levels.begin();
+    
+    std::vector<std::string> order, inner;
+    for (size_t d = 0; d < names.size(); d++) {
+        comp.split(var(names[d]), factors[d], var(names[d] + "_outer"), var(names[d] + "_inner"));
+        order.push_back(names[d] + "_outer");
+        inner.push_back(names[d] + "_inner");
+    }
+    order.insert(order.end(), levels.begin() + first + names.size(), levels.end());
+    order.insert(order.end(), inner.begin(), inner.end());
+    apply_loop_order(comp, order);
+    
+    for (size_t d = 0; d < inner.size(); d++) {
+        comp.unroll(var(inner[d]), factors[d]);
+    }
+    
+    bridge_log() << "[Bridge] Unroll-and-jam: ";
+    for (size_t d = 0; d < names.size(); d++) {
+        bridge_log() << names[d] << "×" << factors[d] << " ";
+    }
+    bridge_log() << std::endl;
+}
+
+bool unroll_jam_is_applicable(
+    computation &comp,
+    const Transformation &trans,
+    std::vector<std::string> &loops,
+    std::string &error) {
+    
+    loops.clear();
+    for (size_t d = 0; d < trans.iterator_names.size() && d < trans.tile_sizes.size(); d++) {
+        if (trans.tile_sizes[d] <= 1) continue;
+        loops.push_back(resolve_loop_name(comp, trans.iterator_names[d], true));
+    }
+    if (loops.empty()) {
+        error = "Unroll-and-jam needs a loop and a factor > 1";
+        return false;
+    }
+    
+    // 被jam的循环须相邻，且下方至少还有一层循环
+    std::vector<std::string> levels = comp.get_loop_level_names();
+    size_t first = std::find(levels.begin(), levels.end(), loops[0]) - levels.begin();
+    for (size_t d = 0; d < loops.size(); d++) {
+        if (first + d >= levels.size() || levels[first + d] != loops[d]) {
+            error = "Unroll-and-jam loops must be adjacent";
+            return false;
+        }
+    }
+    if (first + loops.size() >= levels.size()) {
+        error = "Unroll-and-jam of the innermost loop";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * level是否由原迭代器name经若干次变换得到: name后接的每一段都须是生成的后缀
+ * （_outer / _inner / 0 / 1，或fresh_loop_name的 _sk / _rv / _wf 加可选编号），
+ * 避免 i 误匹配 i_n、ii 之类的其他迭代器
+ */
+static bool is_derived_loop_name(const std::string &level, const std::string &name) {
+    if (level.size() < name.size() || level.compare(0, name.size(), name) != 0) {
+        return false;
+    }
+    
+    static const char *const split_suffixes[] = {"_outer", "_inner", "0", "1"};
+    static const char *const fresh_suffixes[] = {"_sk", "_rv", "_wf"};
+    
+    size_t pos = name.size();
+    while (pos < level.size()) {
+        bool matched = false;
+        for (const char *suffix : split_suffixes) {
+            size_t len = std::strlen(suffix);
+            if (level.compare(pos, len, suffix) == 0) {
+                pos += len;
+                matched = true;
+                break;
+            }
+        }
+        if (matched) continue;
+        
+        for (const char *suffix : fresh_suffixes) {
+            size_t len = std::strlen(suffix);
+            if (level.compare(pos, len, suffix) == 0) {
+                pos += len;
+                while (pos < level.size() && std::isdigit((unsigned char)level[pos])) pos++;
+                matched = true;
+                break;
+            }
+        }
+        if (!matched) return false;
+    }
+    return true;
+}
+
+/**
+ * 查找原迭代器在当前schedule中的循环名
+ */
+std::string resolve_loop_name(
+    computation &comp,
+    const std::string &name,
+    bool prefer_inner) {
+    
+    std::vector<std::string> levels = comp.get_loop_level_names();
+    
+    std::string found;
+    for (const auto &level : levels) {
+        if (!is_derived_loop_name(level, name)) continue;
+        
+        found = level;
+        if (!prefer_inner) break;
+    }
+    
+    // 找不到时原样返回，由Tiramisu报错
+    return found.empty() ? name : found;
 }
 
 /**
@@ -432,22 +1386,24 @@ void PlutoToTiramisuConverter::convert_and_apply(
     PlutoProg *pluto_prog,
     computation &comp) {
     
-    std::cout << "\n╔══════════════════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║  PLUTO → Tiramisu Conversion                              ║" << std::endl;
-    std::cout << "╚══════════════════════════════════════════════════════════╝\n" << std::endl;
+    bridge_log() << "\n╔══════════════════════════════════════════════════════════╗" << std::endl;
+    bridge_log() << "║  PLUTO → Tiramisu Conversion                              ║" << std::endl;
+    bridge_log() << "╚══════════════════════════════════════════════════════════╝\n" << std::endl;
     
     // 提取变换
     auto transforms = extract_transformations(pluto_prog);
     
-    // 打印信息
-    print_transformation_info(transforms);
+    // 打印信息（仅verbose模式）
+    if (BridgeProfiler::instance().verbose()) {
+        print_transformation_info(transforms);
+    }
     
     // 应用变换
     apply_transformations(comp, transforms);
     
-    std::cout << "\n╔══════════════════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║  Conversion Complete                                      ║" << std::endl;
-    std::cout << "╚══════════════════════════════════════════════════════════╝\n" << std::endl;
+    bridge_log() << "\n╔══════════════════════════════════════════════════════════╗" << std::endl;
+    bridge_log() << "║  Conversion Complete                                      ║" << std::endl;
+    bridge_log() << "╚══════════════════════════════════════════════════════════╝\n" << std::endl;
 }
 
 /**
@@ -480,6 +1436,42 @@ void PlutoToTiramisuConverter::print_transformation_info(
             case TRANS_INTERCHANGE:
                 std::cout << "Interchange";
                 break;
+            case TRANS_SKEW:
+                if (trans.coefficients.size() == 4) {
+                    std::cout << "Skew [" << trans.coefficients[0] << " "
+                              << trans.coefficients[1] << "; " << trans.coefficients[2]
+                              << " " << trans.coefficients[3] << "]";
+                } else {
+                    std::cout << "Skew (factor " << trans.factor << ")";
+                }
+                break;
+            case TRANS_REVERSE:
+                std::cout << "Reversal";
+                break;
+            case TRANS_DIAMOND_TILE:
+                std::cout << "Diamond tile: ";
+                for (size_t r = 0; r < trans.tile_sizes.size(); r++) {
+                    std::cout << (r ? "x" : "") << trans.tile_sizes[r];
+                }
+                break;
+            case TRANS_SPLIT:
+                std::cout << "Split (factor " << trans.factor << ")";
+                break;
+            case TRANS_PARALLELIZE:
+                std::cout << "Parallelize";
+                break;
+            case TRANS_VECTORIZE:
+                std::cout << "Vectorize (width " << trans.factor << ")";
+                break;
+            case TRANS_UNROLL:
+                std::cout << "Unroll (factor " << trans.factor << ")";
+                break;
+            case TRANS_UNROLL_JAM:
+                std::cout << "Unroll-and-jam: ";
+                for (size_t d = 0; d < trans.iterator_names.size() && d < trans.tile_sizes.size(); d++) {
+                    std::cout << trans.iterator_names[d] << "×" << trans.tile_sizes[d] << " ";
+                }
+                break;
             default:
                 std::cout << "Unknown";
         }
@@ -33,7 +33,12 @@ enum TransformType {
     TRANS_INTERCHANGE,
     TRANS_SKEW,
     TRANS_PARALLELIZE,
-    TRANS_SPLIT
+    TRANS_SPLIT,
+    TRANS_VECTORIZE,
+    TRANS_UNROLL,
+    TRANS_REVERSE,
+    TRANS_DIAMOND_TILE,
+    TRANS_UNROLL_JAM
 };
 
 /**
@@ -45,7 +50,9 @@ struct Transformation {
     std::vector<int> tile_sizes;        // Tile大小
     std::vector<std::string> iterator_names;  // 迭代器名称（动态）
     int statement_id;                   // 语句ID（多statement支持）
-    int factor;                         // Skew/split因子
+    int factor;                         // Skew/split/vectorize/unroll因子
+    std::vector<int> coefficients;      // Skew系数 {alpha, beta, gamma, sigma}（空: 1, factor）
+    std::vector<std::vector<int64_t>> hyperplanes;  // Diamond tile的循环超平面（每行: 迭代器系数 + 常数）
     
     Transformation(TransformType t) : type(t), statement_id(0), factor(0) {}
 };
@@ -71,6 +78,15 @@ public:
         const std::vector<Transformation> &transforms
     );
     
+    /**
+     * 通过一系列interchange把循环调整到指定顺序（外→内）
+     * 只移动order中出现的循环，其余循环位置不变
+     */
+    void apply_loop_order(
+        tiramisu::computation &comp,
+        const std::vector<std::string> &order
+    );
+    
     /**
      * 检测并应用GPU优化
      */
@@ -101,8 +117,95 @@ private:
     void apply_tile(tiramisu::computation &comp, const Transformation &trans);
     void apply_gpu_tile(tiramisu::computation &comp, const Transformation &trans);
     void apply_interchange(tiramisu::computation &comp, const Transformation &trans);
+    void apply_skew(tiramisu::computation &comp, const Transformation &trans);
+    void apply_reverse(tiramisu::computation &comp, const Transformation &trans);
+    void apply_diamond_tile(tiramisu::computation &comp, const Transformation &trans);
+    void apply_split(tiramisu::computation &comp, const Transformation &trans);
+    void apply_parallelize(tiramisu::computation &comp, const Transformation &trans);
+    void apply_vectorize(tiramisu::computation &comp, const Transformation &trans);
+    void apply_unroll(tiramisu::computation &comp, const Transformation &trans);
+    void apply_unroll_jam(tiramisu::computation &comp, const Transformation &trans);
+};
+
+/**
+ * stmt->trans 的精确分解
+ *
+ * 循环hyperplane的迭代器系数构成的方阵若为幺模矩阵（|det| = 1），
+ * 则它等于原循环层上的一串 2×2 skew 和 loop reversal，再加一次循环置换。
+ * steps 按顺序应用，iterator_names 为所作用循环层的原迭代器名（外层在前）；
+ * level_of_hyperplane[l] 为第l个hyperplane最终所在的原循环层（scalar为-1），
+ * 该层之后的循环名都以此原迭代器名为前缀，可用 resolve_loop_name 查找。
+ * 含scaling（|det| > 1）或循环hyperplane数不等于dim时 exact 为 false。
+ */
+struct ScheduleDecomposition {
+    bool exact;
+    std::vector<Transformation> steps;      // TRANS_SKEW / TRANS_REVERSE
+    std::vector<int> level_of_hyperplane;
+    
+    ScheduleDecomposition() : exact(false) {}
+};
+
+ScheduleDecomposition decompose_statement_schedule(const Stmt *stmt, int statement_id);
+
+/**
+ * 每个PLUTO permutable band的并行循环（按statement列出）
+ *
+ * level为band中最外层的无通信并行hyperplane: band外的循环固定后，
+ * band内语句间的依赖在该层方向全为0（依赖方向和满足层由PLUTO计算）。
+ * band中没有并行层但宽度 >= 2 时为wavefront: level、inner_level为band前两层，
+ * 沿 level + inner_level 的波前顺序执行，inner_level并行。
+ * 非wavefront时 inner_level 为紧接着的并行层（可嵌套并行），-1为无。
+ */
+struct BandParallelism {
+    int statement_id;
+    int level;
+    int inner_level;
+    bool wavefront;
 };
 
+std::vector<BandParallelism> find_parallel_loops(PlutoProg *prog);
+
+/**
+ * PLUTO diamond tiling（diamondtile / fulldiamondtile）的tile band
+ *
+ * prog->is_diamond_tiled 时，最外层band的hyperplane中含有concurrent start
+ * 的面（get_face_with_concurrent_start / find_cone_complement_hyperplane），
+ * 一般不是幺模矩阵，不能分解为skew。每个statement输出一个TRANS_DIAMOND_TILE:
+ * hyperplanes为全部循环超平面（迭代器系数 + 常数，前tile_sizes.size()行为band），
+ * iterator_names为原迭代器。band不在depth 0、宽度 < 2、不含全部statement、
+ * 循环超平面数不等于statement维数或含参数系数时返回空。
+ */
+std::vector<Transformation> diamond_tile_transformations(PlutoProg *prog, int tile_size);
+
+/**
+ * TRANS_DIAMOND_TILE之后的循环名: dtile0..dtile{k-1}（dtile0为波前），
+ * 然后每个point循环取其扫描的原迭代器名（规则同hyperplane_loop_names）
+ */
+std::vector<std::string> diamond_loop_names(const Transformation &trans);
+
+/**
+ * 在computation当前的循环中查找原迭代器name对应的循环
+ * (split/tile之后为 name_outer / name_inner / name0 / name1，skew、reversal、
+ * wavefront之后为 name_sk / name_rv / name_wf，可叠加)。prefer_inner为true时返回最内层的那个
+ */
+std::string resolve_loop_name(
+    tiramisu::computation &comp,
+    const std::string &name,
+    bool prefer_inner
+);
+
+/**
+ * unroll-and-jam能否作用于comp的当前schedule: 有factor > 1的循环，
+ * 被jam的循环（resolve_loop_name最内层）相邻，且下方至少还有一层循环。
+ * 不能时返回false并设置error；loops为被jam的循环名（外→内）
+ */
+bool unroll_jam_is_applicable(
+    tiramisu::computation &comp,
+    const Transformation &trans,
+    std::vector<std::string> &loops,
+    std::string &error
+);
+
 /**
  * 便捷函数：从PLUTO schedule生成Tiramisu代码
  */
@@ -0,0 +1,165 @@
+#include "surrogate_model.h"
+#include <algorithm>
+#include <cmath>
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// Training
+// ============================================================================
+
+void RandomForestSurrogate::fit(
+    const std::vector<std::vector<double>>& X,
+    const std::vector<double>& y
+) {
+    trees_.clear();
+    if (X.empty() || X.size() != y.size()) return;
+    
+    std::uniform_int_distribution<size_t> pick(0, X.size() - 1);
+    
+    for (int t = 0; t < num_trees_; t++) {
+        // Bootstrap sample
+        std::vector<size_t> rows(X.size());
+        for (auto& r : rows) r = pick(rng_);
+        
+        Tree tree;
+        build_node(tree, X, y, rows, 0);
+        trees_.push_back(tree);
+    }
+}
+
+int RandomForestSurrogate::build_node(
+    Tree& tree,
+    const std::vector<std::vector<double>>& X,
+    const std::vector<double>& y,
+    std::vector<size_t>& rows,
+    int depth
+) {
+    double sum = 0.0;
+    for (size_t r : rows) sum += y[r];
+    
+    int id = tree.size();
+    tree.push_back(Node{-1, 0.0, -1, -1, sum / rows.size()});
+    
+    if (depth >= max_depth_ || (int)rows.size() < 2 * min_samples_leaf_) {
+        return id;
+    }
+    
+    // Random feature subset (a third of the features, at least one)
+    size_t nfeatures = X[0].size();
+    std::vector<size_t> features(nfeatures);
+    for (size_t f = 0; f < nfeatures; f++) features[f] = f;
+    std::shuffle(features.begin(), features.end(), rng_);
+    features.resize(std::max<size_t>(1, (nfeatures + 2) / 3));
+    
+    // Best variance-reducing split: minimize SSE_left + SSE_right
+    int best_feature = -1;
+    double best_threshold = 0.0;
+    double best_cost = 0.0;
+    for (size_t r : rows) best_cost += (y[r] - sum / rows.size()) * (y[r] - sum / rows.size());
+    
+    std::vector<size_t> sorted = rows;
+    for (size_t f : features) {
+        std::sort(sorted.begin(), sorted.end(),
+                  [&](size_t a, size_t b) { return X[a][f] < X[b][f]; });
+        
+        double left_sum = 0.0, left_sq = 0.0;
+        double total_sq = 0.0;
+        for (size_t r : sorted) total_sq += y[r] * y[r];
+        
+        for (size_t i = 0; i + 1 < sorted.size(); i++) {
+            double v = y[sorted[i]];
+            left_sum += v;
+            left_sq += v * v;
+            
+            size_t nl = i + 1, nr = sorted.size() - nl;
+            if ((int)nl < min_samples_leaf_ || (int)nr < min_samples_leaf_) continue;
+            if (X[sorted[i]][f] == X[sorted[i + 1]][f]) continue;
+            
+            double right_sum = sum - left_sum;
+            double right_sq = total_sq - left_sq;
+            double cost = (left_sq - left_sum * left_sum / nl) +
+                          (right_sq - right_sum * right_sum / nr);
+            if (cost < best_cost - 1e-12) {
+                best_cost = cost;
+                best_feature = f;
+                best_threshold = 0.5 * (X[sorted[i]][f] + X[sorted[i + 1]][f]);
+            }
+        }
+    }
+    
+    if (best_feature < 0) return id;
+    
+    std::vector<size_t> left_rows, right_rows;
+    for (size_t r : rows) {
+        if (X[r][best_feature] <= best_threshold) {
+            left_rows.push_back(r);
+        } else {
+            right_rows.push_back(r);
+        }
+    }
+    
+    int left = build_node(tree, X, y, left_rows, depth + 1);
+    int right = build_node(tree, X, y, right_rows, depth + 1);
+    
+    tree[id].feature = best_feature;
+    tree[id].threshold = best_threshold;
+    tree[id].left = left;
+    tree[id].right = right;
+    return id;
+}
+
+// ============================================================================
+// Prediction
+// ============================================================================
+
+double RandomForestSurrogate::predict_tree(
+    const Tree& tree,
+    const std::vector<double>& x
+) const {
+    int node = 0;
+    while (tree[node].feature >= 0) {
+        node = x[tree[node].feature] <= tree[node].threshold
+             ? tree[node].left : tree[node].right;
+    }
+    return tree[node].value;
+}
+
+void RandomForestSurrogate::predict(
+    const std::vector<double>& x,
+    double& mean,
+    double& stddev
+) const {
+    mean = 0.0;
+    stddev = 0.0;
+    if (trees_.empty()) return;
+    
+    std::vector<double> preds;
+    for (const auto& tree : trees_) {
+        preds.push_back(predict_tree(tree, x));
+        mean += preds.back();
+    }
+    mean /= preds.size();
+    
+    for (double p : preds) stddev += (p - mean) * (p - mean);
+    stddev = std::sqrt(stddev / preds.size());
+}
+
+double RandomForestSurrogate::expected_improvement(
+    double mean,
+    double stddev,
+    double best_y,
+    double xi
+) {
+    double improvement = best_y - mean - xi;
+    if (stddev <= 1e-12) {
+        return std::max(0.0, improvement);
+    }
+    
+    double z = improvement / stddev;
+    double cdf = 0.5 * std::erfc(-z / std::sqrt(2.0));
+    double pdf = std::exp(-0.5 * z * z) / std::sqrt(2.0 * M_PI);
+    return improvement * cdf + stddev * pdf;
+}
+
+} // namespace pluto_tiramisu
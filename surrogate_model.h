@@ -0,0 +1,63 @@
+#ifndef SURROGATE_MODEL_H
+#define SURROGATE_MODEL_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// Random Forest Surrogate - Cost model for model-based search
+// ============================================================================
+//
+// Bagged regression trees over numeric features. The spread of the tree
+// predictions is used as the uncertainty of the mean, which is what the
+// expected-improvement acquisition needs.
+
+class RandomForestSurrogate {
+public:
+    RandomForestSurrogate(int num_trees = 32, int max_depth = 8,
+                          int min_samples_leaf = 2, uint64_t seed = 42)
+        : num_trees_(num_trees), max_depth_(max_depth),
+          min_samples_leaf_(min_samples_leaf), rng_(seed) {}
+    
+    // Train on rows X (all of the same width) with targets y
+    void fit(const std::vector<std::vector<double>>& X, const std::vector<double>& y);
+    
+    bool is_fitted() const { return !trees_.empty(); }
+    
+    // Mean and standard deviation across trees
+    void predict(const std::vector<double>& x, double& mean, double& stddev) const;
+    
+    // Expected improvement of a prediction below best_y (minimization)
+    static double expected_improvement(double mean, double stddev,
+                                       double best_y, double xi = 0.01);
+
+private:
+    struct Node {
+        int feature;        // -1 for leaves
+        double threshold;   // go left if x[feature] <= threshold
+        int left;
+        int right;
+        double value;       // leaf prediction
+    };
+    typedef std::vector<Node> Tree;
+    
+    int num_trees_;
+    int max_depth_;
+    int min_samples_leaf_;
+    std::mt19937_64 rng_;
+    std::vector<Tree> trees_;
+    
+    int build_node(Tree& tree,
+                   const std::vector<std::vector<double>>& X,
+                   const std::vector<double>& y,
+                   std::vector<size_t>& rows,
+                   int depth);
+    double predict_tree(const Tree& tree, const std::vector<double>& x) const;
+};
+
+} // namespace pluto_tiramisu
+
+#endif // SURROGATE_MODEL_H
@@ -0,0 +1,605 @@
+#include "tuning_database.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+extern "C" {
+#include "constraints.h"
+}
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// On-disk format
+// ============================================================================
+
+namespace {
+
+const char kMagic[8] = {'P', 'G', 'S', 'T', 'U', 'N', 'E', '1'};
+const uint32_t kVersion = 3;  // 2: C, T, L, U lines; 3: policy key, M line
+
+struct DiskHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t capacity;
+    uint64_t count;
+};
+
+struct DiskRecord {
+    uint64_t scop_hash;
+    uint64_t fingerprint;
+    uint64_t policy;
+    double execution_time_ms;
+    uint32_t used;
+    uint32_t payload_len;
+    char payload[4056];
+};
+
+static_assert(sizeof(DiskRecord) == 4096, "DiskRecord must be one page");
+
+// FNV-1a
+const uint64_t kFnvOffset = 1469598103934665603ULL;
+const uint64_t kFnvPrime = 1099511628211ULL;
+
+inline uint64_t fnv_bytes(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+inline uint64_t fnv_int(uint64_t h, int64_t v) {
+    return fnv_bytes(h, &v, sizeof(v));
+}
+
+inline uint64_t fnv_str(uint64_t h, const char* s) {
+    if (!s) return fnv_int(h, -1);
+    return fnv_bytes(h, s, strlen(s) + 1);
+}
+
+// Row-order independent hash of a (union of) constraint system(s)
+uint64_t hash_constraints(uint64_t h, const PlutoConstraints* cst) {
+    for (; cst; cst = cst->next) {
+        std::vector<uint64_t> rows;
+        for (unsigned r = 0; r < cst->nrows; r++) {
+            uint64_t rh = fnv_int(kFnvOffset, cst->is_eq ? cst->is_eq[r] : 0);
+            for (unsigned c = 0; c < cst->ncols; c++) {
+                rh = fnv_int(rh, cst->val[r][c]);
+            }
+            rows.push_back(rh);
+        }
+        std::sort(rows.begin(), rows.end());
+        
+        h = fnv_int(h, cst->ncols);
+        h = fnv_int(h, rows.size());
+        for (uint64_t rh : rows) {
+            h = fnv_int(h, rh);
+        }
+    }
+    return h;
+}
+
+uint64_t hash_matrix(uint64_t h, const PlutoMatrix* mat) {
+    if (!mat) return fnv_int(h, -1);
+    h = fnv_int(h, mat->nrows);
+    h = fnv_int(h, mat->ncols);
+    for (unsigned r = 0; r < mat->nrows; r++) {
+        for (unsigned c = 0; c < mat->ncols; c++) {
+            h = fnv_int(h, mat->val[r][c]);
+        }
+    }
+    return h;
+}
+
+uint64_t hash_access(uint64_t h, const PlutoAccess* acc) {
+    h = fnv_str(h, acc->name);
+    return hash_matrix(h, acc->mat);
+}
+
+} // namespace
+
+// ============================================================================
+// Hashing
+// ============================================================================
+
+uint64_t TuningDatabase::hash_scop(
+    const PlutoProg* prog,
+    const std::map<std::string, int64_t>& param_values
+) {
+    uint64_t h = kFnvOffset;
+    if (!prog) return h;
+    
+    h = fnv_int(h, prog->nstmts);
+    h = fnv_int(h, prog->npar);
+    
+    for (unsigned s = 0; s < prog->nstmts; s++) {
+        const Stmt* stmt = prog->stmts[s];
+        h = fnv_int(h, stmt->dim);
+        h = hash_constraints(h, stmt->domain);
+        
+        h = fnv_int(h, stmt->nreads);
+        for (int r = 0; r < stmt->nreads; r++) {
+            h = hash_access(h, stmt->reads[r]);
+        }
+        h = fnv_int(h, stmt->nwrites);
+        for (int w = 0; w < stmt->nwrites; w++) {
+            h = hash_access(h, stmt->writes[w]);
+        }
+    }
+    
+    // Dependences: order-independent like constraint rows
+    std::vector<uint64_t> deps;
+    for (int d = 0; d < prog->ndeps; d++) {
+        const Dep* dep = prog->deps[d];
+        uint64_t dh = kFnvOffset;
+        dh = fnv_int(dh, dep->src);
+        dh = fnv_int(dh, dep->dest);
+        dh = fnv_int(dh, dep->type);
+        dh = hash_constraints(dh, dep->dpolytope);
+        deps.push_back(dh);
+    }
+    std::sort(deps.begin(), deps.end());
+    h = fnv_int(h, deps.size());
+    for (uint64_t dh : deps) {
+        h = fnv_int(h, dh);
+    }
+    
+    // Parameters: context plus the concrete values used for measurement
+    h = hash_constraints(h, prog->param_context);
+    for (int p = 0; p < prog->npar; p++) {
+        const char* name = prog->params ? prog->params[p] : nullptr;
+        h = fnv_str(h, name);
+        auto it = name ? param_values.find(name) : param_values.end();
+        h = fnv_int(h, it != param_values.end() ? it->second : INT64_MIN);
+    }
+    
+    return h;
+}
+
+uint64_t TuningDatabase::machine_fingerprint() {
+    // Computed once per process (lookups must stay in the microsecond range)
+    static const uint64_t cached = []() {
+        uint64_t h = kFnvOffset;
+        
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 10, "model name") == 0) {
+                h = fnv_str(h, line.c_str());
+                break;
+            }
+        }
+        
+        h = fnv_int(h, std::thread::hardware_concurrency());
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+        h = fnv_int(h, sysconf(_SC_LEVEL1_DCACHE_SIZE));
+        h = fnv_int(h, sysconf(_SC_LEVEL2_CACHE_SIZE));
+        h = fnv_int(h, sysconf(_SC_LEVEL3_CACHE_SIZE));
+#endif
+
+        return h;
+    }();
+    return cached;
+}
+
+uint64_t TuningDatabase::policy_key(const SelectionPolicy& policy) {
+    uint64_t h = kFnvOffset;
+    h = fnv_int(h, policy.primary);
+    h = fnv_bytes(h, &policy.tolerance, sizeof(policy.tolerance));
+    h = fnv_int(h, policy.secondary);
+    return h;
+}
+
+// ============================================================================
+// Config serialization
+// ============================================================================
+//
+//   X <type> <stmt> <factor> <n> dims... <n> sizes... <n> names...
+//   C <n> coefficients...             (skew coefficients of the preceding X)
+//   H <n> coefficients...             (hyperplane rows of the preceding X)
+//   S <loop_name> <size>
+//   L <level> <loop_name> <size>      (outer tile levels, outermost = 0)
+//   U <loop_name> <factor>            (register tile: unroll-and-jam)
+//   T <stmt> <fused> <n> scalar dims... <n> loop order...
+//                                     (per-statement schedule)
+//   M <ci_low> <ci_high> <p99> <cv> <compile_ms> <code_size> <scratch>
+//                                     (measured metrics, for the policy)
+//   D <description>
+
+std::string TuningDatabase::serialize_config(const ScheduleConfig& config) {
+    std::ostringstream out;
+    
+    for (const auto& t : config.transformations) {
+        out << "X " << (int)t.type << " " << t.statement_id << " " << t.factor;
+        out << " " << t.loop_dims.size();
+        for (int d : t.loop_dims) out << " " << d;
+        out << " " << t.tile_sizes.size();
+        for (int s : t.tile_sizes) out << " " << s;
+        out << " " << t.iterator_names.size();
+        for (const auto& n : t.iterator_names) out << " " << n;
+        out << "\n";
+        if (!t.coefficients.empty()) {
+            out << "C " << t.coefficients.size();
+            for (int c : t.coefficients) out << " " << c;
+            out << "\n";
+        }
+        for (const auto& row : t.hyperplanes) {
+            out << "H " << row.size();
+            for (int64_t c : row) out << " " << c;
+            out << "\n";
+        }
+    }
+    for (const auto& ts : config.tile_sizes) {
+        out << "S " << ts.loop_name << " " << ts.size << "\n";
+    }
+    for (size_t l = 0; l < config.outer_tile_sizes.size(); l++) {
+        for (const auto& ts : config.outer_tile_sizes[l]) {
+            out << "L " << l << " " << ts.loop_name << " " << ts.size << "\n";
+        }
+    }
+    for (const auto& ts : config.unroll_jam) {
+        out << "U " << ts.loop_name << " " << ts.size << "\n";
+    }
+    for (const auto& st : config.statements) {
+        out << "T " << st.statement_id << " " << st.fused_loops;
+        out << " " << st.scalar_dims.size();
+        for (int64_t v : st.scalar_dims) out << " " << v;
+        out << " " << st.loop_order.size();
+        for (const auto& n : st.loop_order) out << " " << n;
+        out << "\n";
+    }
+    out << "M " << config.time_ci_low_ms << " " << config.time_ci_high_ms << " "
+        << config.time_p99_ms << " " << config.time_cv << " "
+        << config.compile_time_ms << " " << config.code_size_bytes << " "
+        << config.scratch_bytes << "\n";
+    out << "D " << config.description << "\n";
+    
+    return out.str();
+}
+
+bool TuningDatabase::deserialize_config(const std::string& text, ScheduleConfig& config) {
+    config = ScheduleConfig();
+    std::istringstream in(text);
+    std::string line;
+    
+    while (std::getline(in, line)) {
+        if (line.size() < 2) continue;
+        std::istringstream ls(line.substr(2));
+        
+        if (line[0] == 'X') {
+            int type = 0;
+            size_t n = 0;
+            ls >> type;
+            Transformation t((TransformType)type);
+            ls >> t.statement_id >> t.factor;
+            ls >> n;
+            t.loop_dims.resize(n);
+            for (auto& d : t.loop_dims) ls >> d;
+            ls >> n;
+            t.tile_sizes.resize(n);
+            for (auto& s : t.tile_sizes) ls >> s;
+            ls >> n;
+            t.iterator_names.resize(n);
+            for (auto& name : t.iterator_names) ls >> name;
+            if (ls.fail()) return false;
+            config.transformations.push_back(t);
+        } else if (line[0] == 'C') {
+            size_t n = 0;
+            ls >> n;
+            std::vector<int> coefficients(n);
+            for (auto& c : coefficients) ls >> c;
+            if (ls.fail() || config.transformations.empty()) return false;
+            config.transformations.back().coefficients = coefficients;
+        } else if (line[0] == 'H') {
+            size_t n = 0;
+            ls >> n;
+            std::vector<int64_t> row(n);
+            for (auto& c : row) ls >> c;
+            if (ls.fail() || config.transformations.empty()) return false;
+            config.transformations.back().hyperplanes.push_back(row);
+        } else if (line[0] == 'S') {
+            ScheduleConfig::TileSize ts;
+            ls >> ts.loop_name >> ts.size;
+            if (ls.fail()) return false;
+            config.tile_sizes.push_back(ts);
+        } else if (line[0] == 'L') {
+            size_t level = 0;
+            ScheduleConfig::TileSize ts;
+            ls >> level >> ts.loop_name >> ts.size;
+            if (ls.fail()) return false;
+            if (config.outer_tile_sizes.size() <= level) {
+                config.outer_tile_sizes.resize(level + 1);
+            }
+            config.outer_tile_sizes[level].push_back(ts);
+        } else if (line[0] == 'U') {
+            ScheduleConfig::TileSize ts;
+            ls >> ts.loop_name >> ts.size;
+            if (ls.fail()) return false;
+            config.unroll_jam.push_back(ts);
+        } else if (line[0] == 'T') {
+            StatementSchedule st;
+            size_t n = 0;
+            ls >> st.statement_id >> st.fused_loops;
+            ls >> n;
+            st.scalar_dims.resize(n);
+            for (auto& v : st.scalar_dims) ls >> v;
+            ls >> n;
+            st.loop_order.resize(n);
+            for (auto& name : st.loop_order) ls >> name;
+            if (ls.fail()) return false;
+            config.statements.push_back(st);
+        } else if (line[0] == 'M') {
+            ls >> config.time_ci_low_ms >> config.time_ci_high_ms >> config.time_p99_ms
+               >> config.time_cv >> config.compile_time_ms >> config.code_size_bytes
+               >> config.scratch_bytes;
+            if (ls.fail()) return false;
+        } else if (line[0] == 'D') {
+            config.description = line.substr(2);
+        }
+    }
+    
+    return true;
+}
+
+// ============================================================================
+// Memory-mapped table
+// ============================================================================
+
+bool TuningDatabase::open(const std::string& path, uint64_t initial_capacity) {
+    close();
+    path_ = path;
+    
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        std::cerr << "[TuningDB] Cannot open " << path << "\n";
+        return false;
+    }
+    
+    // Another process may be creating the same file: size check and header
+    // initialization happen under the exclusive lock (close() releases it)
+    flock(fd_, LOCK_EX);
+    
+    struct stat st;
+    fstat(fd_, &st);
+    
+    if (st.st_size < (off_t)sizeof(DiskHeader)) {
+        // New file
+        initial_capacity = std::max<uint64_t>(initial_capacity, 16);
+        size_t size = sizeof(DiskHeader) + initial_capacity * sizeof(DiskRecord);
+        if (ftruncate(fd_, size) != 0 || !map_file(size)) {
+            close();
+            return false;
+        }
+        DiskHeader* hdr = (DiskHeader*)base_;
+        memcpy(hdr->magic, kMagic, sizeof(kMagic));
+        hdr->version = kVersion;
+        hdr->record_size = sizeof(DiskRecord);
+        hdr->capacity = initial_capacity;
+        hdr->count = 0;
+        flock(fd_, LOCK_UN);
+        return true;
+    }
+    
+    if (!map_file(st.st_size)) {
+        close();
+        return false;
+    }
+    
+    DiskHeader* hdr = (DiskHeader*)base_;
+    if (memcmp(hdr->magic, kMagic, sizeof(kMagic)) == 0 && hdr->version != kVersion) {
+        std::cerr << "[TuningDB] " << path << " has format version " << hdr->version
+                  << " (expected " << kVersion << ")\n";
+        close();
+        return false;
+    }
+    if (memcmp(hdr->magic, kMagic, sizeof(kMagic)) != 0 ||
+        hdr->record_size != sizeof(DiskRecord) ||
+        sizeof(DiskHeader) + hdr->capacity * sizeof(DiskRecord) > mapped_size_) {
+        std::cerr << "[TuningDB] " << path << " is not a tuning database\n";
+        close();
+        return false;
+    }
+    
+    flock(fd_, LOCK_UN);
+    return true;
+}
+
+void TuningDatabase::close() {
+    if (base_) {
+        munmap(base_, mapped_size_);
+        base_ = nullptr;
+        mapped_size_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool TuningDatabase::map_file(size_t size) {
+    if (base_) {
+        munmap(base_, mapped_size_);
+        base_ = nullptr;
+    }
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "[TuningDB] mmap failed\n";
+        return false;
+    }
+    base_ = p;
+    mapped_size_ = size;
+    return true;
+}
+
+uint64_t TuningDatabase::size() const {
+    return base_ ? ((const DiskHeader*)base_)->count : 0;
+}
+
+int64_t TuningDatabase::find_slot(uint64_t scop_hash, uint64_t fingerprint, uint64_t policy,
+                                  bool for_insert) {
+    DiskHeader* hdr = (DiskHeader*)base_;
+    DiskRecord* recs = (DiskRecord*)(hdr + 1);
+    uint64_t cap = hdr->capacity;
+    
+    uint64_t start = (scop_hash ^ ((fingerprint ^ policy) * kFnvPrime)) % cap;
+    for (uint64_t probe = 0; probe < cap; probe++) {
+        uint64_t i = (start + probe) % cap;
+        if (!recs[i].used) {
+            return for_insert ? (int64_t)i : -1;
+        }
+        if (recs[i].scop_hash == scop_hash && recs[i].fingerprint == fingerprint &&
+            recs[i].policy == policy) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool TuningDatabase::remap_if_grown() {
+    // Another process may have grown the file since we mapped it
+    uint64_t cap = ((DiskHeader*)base_)->capacity;
+    size_t needed = sizeof(DiskHeader) + cap * sizeof(DiskRecord);
+    return needed <= mapped_size_ || map_file(needed);
+}
+
+bool TuningDatabase::lookup(uint64_t scop_hash, TuningRecord& record,
+                            const SelectionPolicy& policy) {
+    if (!base_) return false;
+    
+    // Shared lock: a concurrent store may be growing (rehashing) the table
+    // or rewriting this record; copy it out under the lock
+    flock(fd_, LOCK_SH);
+    if (!remap_if_grown()) {
+        flock(fd_, LOCK_UN);
+        return false;
+    }
+    
+    uint64_t fingerprint = machine_fingerprint();
+    int64_t slot = find_slot(scop_hash, fingerprint, policy_key(policy), false);
+    if (slot < 0) {
+        flock(fd_, LOCK_UN);
+        return false;
+    }
+    
+    const DiskRecord& rec = ((DiskRecord*)((DiskHeader*)base_ + 1))[slot];
+    record.scop_hash = rec.scop_hash;
+    record.machine_fingerprint = rec.fingerprint;
+    record.policy_key = rec.policy;
+    record.execution_time_ms = rec.execution_time_ms;
+    std::string payload(rec.payload, rec.payload_len);
+    flock(fd_, LOCK_UN);
+    
+    if (!deserialize_config(payload, record.config)) {
+        return false;
+    }
+    record.config.execution_time_ms = record.execution_time_ms;
+    return true;
+}
+
+bool TuningDatabase::grow() {
+    DiskHeader* hdr = (DiskHeader*)base_;
+    DiskRecord* recs = (DiskRecord*)(hdr + 1);
+    
+    std::vector<DiskRecord> live;
+    for (uint64_t i = 0; i < hdr->capacity; i++) {
+        if (recs[i].used) live.push_back(recs[i]);
+    }
+    
+    uint64_t new_cap = hdr->capacity * 2;
+    size_t size = sizeof(DiskHeader) + new_cap * sizeof(DiskRecord);
+    if (ftruncate(fd_, size) != 0 || !map_file(size)) {
+        return false;
+    }
+    
+    hdr = (DiskHeader*)base_;
+    recs = (DiskRecord*)(hdr + 1);
+    hdr->capacity = new_cap;
+    hdr->count = 0;
+    memset(recs, 0, new_cap * sizeof(DiskRecord));
+    
+    for (const auto& rec : live) {
+        int64_t slot = find_slot(rec.scop_hash, rec.fingerprint, rec.policy, true);
+        recs[slot] = rec;
+        hdr->count++;
+    }
+    return true;
+}
+
+bool TuningDatabase::store(
+    uint64_t scop_hash,
+    const ScheduleConfig& config,
+    double execution_time_ms,
+    const SelectionPolicy& policy,
+    bool force
+) {
+    if (!base_) return false;
+    
+    std::string payload = serialize_config(config);
+    if (payload.size() > sizeof(DiskRecord::payload)) {
+        std::cerr << "[TuningDB] Config too large to store ("
+                  << payload.size() << " bytes)\n";
+        return false;
+    }
+    
+    // Serialize writers that share the file
+    flock(fd_, LOCK_EX);
+    if (!remap_if_grown()) {
+        flock(fd_, LOCK_UN);
+        return false;
+    }
+    
+    DiskHeader* hdr = (DiskHeader*)base_;
+    if (2 * (hdr->count + 1) > hdr->capacity && !grow()) {
+        flock(fd_, LOCK_UN);
+        return false;
+    }
+    hdr = (DiskHeader*)base_;
+    
+    uint64_t fingerprint = machine_fingerprint();
+    uint64_t policy_hash = policy_key(policy);
+    int64_t slot = find_slot(scop_hash, fingerprint, policy_hash, true);
+    DiskRecord& rec = ((DiskRecord*)(hdr + 1))[slot];
+    
+    // The stored config stays unless the policy picks the new one over it
+    // (ties keep the stored one)
+    bool exists = rec.used != 0;
+    if (exists && !force) {
+        ScheduleConfig stored, incoming = config;
+        if (deserialize_config(std::string(rec.payload, rec.payload_len), stored)) {
+            stored.execution_time_ms = rec.execution_time_ms;
+            incoming.execution_time_ms = execution_time_ms;
+            ScheduleConfig chosen = select_by_policy({stored, incoming}, policy);
+            if (serialize_config(chosen) != payload) {
+                flock(fd_, LOCK_UN);
+                return true;
+            }
+        }
+    }
+    
+    rec.scop_hash = scop_hash;
+    rec.fingerprint = fingerprint;
+    rec.policy = policy_hash;
+    rec.execution_time_ms = execution_time_ms;
+    rec.payload_len = payload.size();
+    memcpy(rec.payload, payload.data(), payload.size());
+    rec.used = 1;
+    if (!exists) hdr->count++;
+    
+    msync(base_, mapped_size_, MS_ASYNC);
+    flock(fd_, LOCK_UN);
+    return true;
+}
+
+} // namespace pluto_tiramisu
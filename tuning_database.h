@@ -0,0 +1,88 @@
+#ifndef TUNING_DATABASE_H
+#define TUNING_DATABASE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include "pluto_guided_search.h"
+
+namespace pluto_tiramisu {
+
+// ============================================================================
+// Tuning Database - Persistent best-config cache keyed by SCoP hash
+// ============================================================================
+//
+// File layout (memory-mapped, open addressing with linear probing):
+//   [Header][Record 0][Record 1]...[Record capacity-1]
+// A record is identified by (scop_hash, machine_fingerprint, policy_key),
+// so one file can be shared by several tuning machines, and a config chosen
+// under one selection policy is never replaced by one chosen under another.
+
+struct TuningRecord {
+    uint64_t scop_hash;
+    uint64_t machine_fingerprint;
+    uint64_t policy_key;
+    double execution_time_ms;
+    ScheduleConfig config;
+};
+
+class TuningDatabase {
+public:
+    TuningDatabase() : fd_(-1), base_(nullptr), mapped_size_(0) {}
+    ~TuningDatabase() { close(); }
+    
+    TuningDatabase(const TuningDatabase&) = delete;
+    TuningDatabase& operator=(const TuningDatabase&) = delete;
+    
+    // Open (or create) the database file
+    bool open(const std::string& path, uint64_t initial_capacity = 1024);
+    void close();
+    bool is_open() const { return base_ != nullptr; }
+    
+    // Lookup the config selected by policy for this SCoP on this machine
+    bool lookup(uint64_t scop_hash, TuningRecord& record,
+                const SelectionPolicy& policy = SelectionPolicy());
+    
+    // Insert or replace (keeps the entry the policy prefers unless force is set)
+    bool store(uint64_t scop_hash,
+               const ScheduleConfig& config,
+               double execution_time_ms,
+               const SelectionPolicy& policy = SelectionPolicy(),
+               bool force = false);
+    
+    uint64_t size() const;
+    
+    // Canonical hash of a PlutoProg: statement domains, dependences,
+    // access matrices and parameter values. Row order inside constraint
+    // systems does not affect the hash.
+    static uint64_t hash_scop(
+        const PlutoProg* prog,
+        const std::map<std::string, int64_t>& param_values = {}
+    );
+    
+    // CPU model, core count and cache geometry of this machine
+    static uint64_t machine_fingerprint();
+    
+    // Objectives and tolerance of a selection policy
+    static uint64_t policy_key(const SelectionPolicy& policy);
+    
+    // Text (de)serialization of a config, stored in the record payload
+    static std::string serialize_config(const ScheduleConfig& config);
+    static bool deserialize_config(const std::string& text, ScheduleConfig& config);
+
+private:
+    std::string path_;
+    int fd_;
+    void* base_;
+    size_t mapped_size_;
+    
+    bool map_file(size_t size);
+    bool remap_if_grown();
+    bool grow();
+    int64_t find_slot(uint64_t scop_hash, uint64_t fingerprint, uint64_t policy,
+                      bool for_insert);
+};
+
+} // namespace pluto_tiramisu
+
+#endif // TUNING_DATABASE_H